@@ -0,0 +1,197 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#include <array>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include "listops.hpp"
+#include "reduce.hpp"
+#include "divconq.hpp"
+#include "accumulate.hpp"
+#include "testops.hpp"
+#ifdef BIT_ACCURATE
+#include "ap_int.h"
+typedef ap_int<48> acc48_t;
+#else
+typedef long long acc48_t;
+#endif
+
+#define LOG_LIST_LENGTH 6
+#define LIST_LENGTH (1<<LOG_LIST_LENGTH)
+#define NUM_TRIALS 100
+
+class Add{
+public:
+	template <typename T>
+	T operator()(std::array<T, 1> L, std::array<T, 1> R){
+		return L[0] + R[0];
+	}
+	template <typename T>
+	T operator()(T L, T R){
+		return L + R;
+	}
+};
+
+float hw_synth_reduce_add(std::array<float, LIST_LENGTH> IN){
+#pragma HLS PIPELINE
+	return reduce<Add>(0.0f, IN);
+}
+
+float hw_synth_divconq_add(std::array<float, LIST_LENGTH> IN){
+#pragma HLS PIPELINE
+	return divconq<Add>(IN);
+}
+
+float hw_synth_pairwise_add(std::array<float, LIST_LENGTH> IN){
+#pragma HLS PIPELINE
+	return pairwise<Add>(IN);
+}
+
+float hw_synth_reduce_widen(std::array<float, LIST_LENGTH> IN){
+#pragma HLS PIPELINE
+	return reduce<Widen<Add, double>>(0.0, IN);
+}
+
+float hw_synth_divconq_widen(std::array<float, LIST_LENGTH> IN){
+#pragma HLS PIPELINE
+	return divconq<Widen<Add, double>>(IN);
+}
+
+float hw_synth_reduce_neumaier(std::array<float, LIST_LENGTH> IN){
+#pragma HLS PIPELINE
+	return reduce<NeumaierAdd>(neumaier_t<float>{0.0f, 0.0f}, IN);
+}
+
+float hw_synth_divconq_neumaier(std::array<float, LIST_LENGTH> IN){
+#pragma HLS PIPELINE
+	return divconq<NeumaierAdd>(IN);
+}
+
+acc48_t hw_synth_reduce_widen_int16(std::array<int16_t, LIST_LENGTH> IN){
+#pragma HLS PIPELINE
+	return reduce<Widen<Add, acc48_t>>(acc48_t(0), IN);
+}
+
+// Half of the list is large values that cancel exactly, and half is small
+// values, so the exact sum is much smaller than the partial sums. All of
+// the values are multiples of 1/16, so the exact sum is representable as
+// a float (and every partial sum is exact in a double).
+std::array<float, LIST_LENGTH> genfloats(std::mt19937& GEN){
+	std::array<float, LIST_LENGTH> in;
+	std::uniform_int_distribution<int> big(-1000000, 1000000);
+	std::uniform_int_distribution<int> small(-1000, 1000);
+	for(int i = 0; i < LIST_LENGTH/4; ++i){
+		int v = big(GEN);
+		in[2*i] = v * 64.0f;
+		in[2*i + 1] = -v * 64.0f;
+	}
+	for(int i = 0; i < LIST_LENGTH/2; ++i){
+		in[LIST_LENGTH/2 + i] = small(GEN) / 16.0f;
+	}
+	std::shuffle(in.begin(), in.end(), GEN);
+	return in;
+}
+
+int test_float_sum(){
+	// All of the inputs come from one generator with a fixed seed, so that
+	// the error statistics are the same on every run
+	std::mt19937 gen(32);
+	double err_chain = 0, err_neumaier = 0;
+	int differ = 0;
+	for(int t = 0; t < NUM_TRIALS; ++t){
+		std::array<float, LIST_LENGTH> in = genfloats(gen);
+		long double exact = 0;
+		for(int i = 0; i < LIST_LENGTH; ++i){
+			exact += in[i];
+		}
+		float gold = exact;
+
+		float chain = hw_synth_reduce_add(in), tree = hw_synth_divconq_add(in);
+		differ += (chain != tree);
+		err_chain = std::max(err_chain, (double)std::abs(chain - gold));
+
+		float wchain = hw_synth_reduce_widen(in), wtree = hw_synth_divconq_widen(in);
+		if(wchain != gold || wtree != gold){
+			fprintf(stderr, "Error! Widened sum returned the incorrect value. Chain: %f, Tree: %f, Gold: %f\n", wchain, wtree, gold);
+			return -1;
+		}
+
+		float nchain = hw_synth_reduce_neumaier(in), ntree = hw_synth_divconq_neumaier(in);
+		err_neumaier = std::max(err_neumaier, (double)std::max(std::abs(nchain - gold), std::abs(ntree - gold)));
+		if(std::abs(nchain - gold) > 1.0f / 16 || std::abs(ntree - gold) > 1.0f / 16){
+			fprintf(stderr, "Error! Compensated sum returned the incorrect value. Chain: %f, Tree: %f, Gold: %f\n", nchain, ntree, gold);
+			return -1;
+		}
+
+		if(hw_synth_pairwise_add(in) != tree){
+			fprintf(stderr, "Error! Pairwise sum did not match the divconq tree\n");
+			return -1;
+		}
+	}
+	printf("Plain float: chain and tree differ in %d/%d trials, max error %f\n", differ, NUM_TRIALS, err_chain);
+	printf("Sum (Widen<Add, double>) Test Passed! Chain and tree are exact\n");
+	printf("Sum (NeumaierAdd) Test Passed! Max error %f\n", err_neumaier);
+	printf("Sum (pairwise) Test Passed! Matches divconq bit-for-bit\n");
+	return 0;
+}
+
+int test_int16_sum(){
+	std::array<int, LIST_LENGTH> input = genarr<-32000, 32000, LIST_LENGTH>();
+	std::array<int16_t, LIST_LENGTH> in;
+	long long gold = 0;
+	for(int i = 0; i < LIST_LENGTH; ++i){
+		in[i] = input[i];
+		gold += input[i];
+	}
+	long long out = (long long)hw_synth_reduce_widen_int16(in);
+	if(out != gold){
+		fprintf(stderr, "Error! Widened int16 sum returned the incorrect value. Output: %lld, Gold: %lld\n", out, gold);
+		return -1;
+	}
+	printf("Sum (Widen<Add, int48>) Test Passed!\n");
+	return 0;
+}
+
+int main(){
+	int err;
+	if((err = test_float_sum())){
+		return err;
+	}
+	if((err = test_int16_sum())){
+		return err;
+	}
+	printf("Accumulate Tests passed\n");
+	return 0;	
+}
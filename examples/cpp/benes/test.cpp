@@ -0,0 +1,122 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#include <array>
+#include <algorithm>
+#include <random>
+#include "listops.hpp"
+#include "benes.hpp"
+#include "testops.hpp"
+#ifdef BIT_ACCURATE
+#include "ap_int.h"
+#endif
+
+#define LOG_LIST_LENGTH 6
+#define LIST_LENGTH (1<<LOG_LIST_LENGTH)
+#define NUM_PERMS 1000
+
+typedef benes<int, LIST_LENGTH> benes_t;
+
+std::array<int, LIST_LENGTH> hw_synth_benes_route(std::array<int, LIST_LENGTH> IN, benes_t::config_t CFG){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS ARRAY_PARTITION complete VARIABLE=CFG._M_instance
+#pragma HLS PIPELINE
+	return route(IN, CFG);
+}
+
+// A LEN x LEN crossbar: every output selects any input
+std::array<int, LIST_LENGTH> hw_synth_for_route(std::array<int, LIST_LENGTH> IN, std::array<std::size_t, LIST_LENGTH> SRC){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS ARRAY_PARTITION complete VARIABLE=SRC._M_instance
+#pragma HLS PIPELINE
+	std::array<int, LIST_LENGTH> out;
+#pragma HLS ARRAY_PARTITION complete VARIABLE=out._M_instance
+	for(int i = 0; i < LIST_LENGTH; ++i){
+#pragma HLS UNROLL
+		out[i] = IN[SRC[i]];
+	}
+	return out;
+}
+
+template <std::size_t LEN>
+int test_permutations(std::mt19937& GEN){
+	std::array<std::size_t, LEN> src = range<LEN>();
+	std::array<int, LEN> in = genarr<-1000, 1000, LEN>();
+	for(int p = 0; p < NUM_PERMS; ++p){
+		std::shuffle(src.begin(), src.end(), GEN);
+		auto out = benes<int, LEN>::route(in, benes<int, LEN>::configure(src));
+		for(std::size_t i = 0; i < LEN; ++i){
+			if(out[i] != in[src[i]]){
+				fprintf(stderr, "Error! Benes (%d inputs) routed the wrong value to index %d\n", (int)LEN, (int)i);
+				return -1;
+			}
+		}
+	}
+	printf("Benes %d-input Test Passed!\n", (int)LEN);
+	return 0;
+}
+
+int test_route(){
+	std::mt19937 gen(std::random_device{}());
+	std::array<std::size_t, LIST_LENGTH> src = range<LIST_LENGTH>();
+	std::array<int, LIST_LENGTH> in = genarr<-1000, 1000, LIST_LENGTH>();
+	for(int p = 0; p < NUM_PERMS; ++p){
+		std::shuffle(src.begin(), src.end(), gen);
+		auto out = hw_synth_benes_route(in, benes_t::configure(src));
+		auto gold = hw_synth_for_route(in, src);
+		for(int i = 0; i < LIST_LENGTH; ++i){
+			if(out[i] != gold[i]){
+				fprintf(stderr, "Error! Benes routed the wrong value to index %d. Output: %d, Gold: %d\n", i, out[i], gold[i]);
+				return -1;
+			}
+		}
+	}
+	printf("Benes (route) Test Passed! %d switches vs. %d crossbar inputs\n", 
+		(int)benes_t::SWITCHES, LIST_LENGTH * LIST_LENGTH);
+
+	if(test_permutations<2>(gen) || test_permutations<4>(gen) || test_permutations<8>(gen) ||
+		test_permutations<256>(gen)){
+		return -1;
+	}
+	return 0;
+}
+
+int main(){
+	int err;
+	if((err = test_route())){
+		return err;
+	}
+	printf("Benes Tests passed\n");
+	return 0;	
+}
@@ -0,0 +1,291 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#include <array>
+#include <chrono>
+#include <climits>
+#include <random>
+#include <type_traits>
+#include "constmult.hpp"
+#include "map.hpp"
+#include "zip.hpp"
+#include "reduce.hpp"
+#include "listops.hpp"
+#include "testops.hpp"
+
+#define LIST_LENGTH 64
+#define NUM_TESTS 1024
+#define BENCH_LENGTH 4096
+#define BENCH_ITERS 4096
+
+// Multiplies by VAL with a multiplier, as in the map and reduce tests
+template <long long VAL>
+struct MultBy{
+	template <typename T>
+	T operator()(T const& IN){
+#pragma HLS INLINE
+		return VAL*IN;
+	}
+};
+
+struct Add{
+	template <typename T>
+	T operator()(T const& L, T const& R){
+#pragma HLS INLINE
+		return L + R;
+	}
+};
+
+// The filter coefficients of the window test, (k * 7) % 13 - 6
+#define TAPS -6, 1, -5, 2, -4, 3, -3, 4
+#define NUM_TAPS 8
+typedef ConstMults<TAPS> FirTaps;
+
+std::array<int, LIST_LENGTH> hw_synth_constmult(std::array<int, LIST_LENGTH> IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS PIPELINE
+	return map<ConstMult<35>>(IN);
+}
+
+std::array<int, LIST_LENGTH> hw_synth_multby(std::array<int, LIST_LENGTH> IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS PIPELINE
+	return map<MultBy<35>>(IN);
+}
+
+// Transposed-form FIR (as in the window test), with every product of a
+// sample and the taps from one multiple-constant multiplier
+std::array<int, LIST_LENGTH> hw_synth_mcm_fir(std::array<int, NUM_TAPS>& ACC, std::array<int, LIST_LENGTH> IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=ACC._M_instance
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS PIPELINE
+	std::array<int, LIST_LENGTH> out;
+#pragma HLS ARRAY_PARTITION complete VARIABLE=out._M_instance
+	for(std::size_t i = 0; i < LIST_LENGTH; ++i){
+#pragma HLS UNROLL
+		ACC = zipWith<Add>(shiftl(ACC, 0), FirTaps()(IN[i]));
+		out[i] = head(ACC);
+	}
+	return out;
+}
+
+// X * VAL, wrapping around like the shift-add tree does
+template <long long VAL, typename T>
+T gold_mult(T X){
+	typedef typename std::make_unsigned<T>::type U;
+	return (T)((U)X * (U)VAL);
+}
+
+template <typename T>
+std::array<T, NUM_TESTS> gen_inputs(){
+	std::array<T, NUM_TESTS> in;
+	std::mt19937_64 gen(46);
+	std::uniform_int_distribution<T> full(std::numeric_limits<T>::min(), std::numeric_limits<T>::max());
+	std::uniform_int_distribution<T> small(-1000, 1000);
+	for(std::size_t i = 0; i < NUM_TESTS; ++i){
+		in[i] = (i & 1) ? full(gen) : small(gen);
+	}
+	in[0] = 0;
+	in[1] = 1;
+	in[2] = -1;
+	in[3] = std::numeric_limits<T>::max();
+	in[4] = std::numeric_limits<T>::min();
+	return in;
+}
+
+template <typename T, long long VAL>
+int test_const(std::array<T, NUM_TESTS> const& IN){
+	std::array<T, NUM_TESTS> out = map<ConstMult<VAL>>(IN);
+	for(std::size_t i = 0; i < NUM_TESTS; ++i){
+		if(out[i] != gold_mult<VAL>(IN[i]) || ConstMult<VAL>::tree(IN[i]) != gold_mult<VAL>(IN[i])){
+			fprintf(stderr, "Error! ConstMult<%lld> returned the incorrect value for %lld. Gold: %lld, Result: %lld, Tree: %lld\n",
+				VAL, (long long)IN[i], (long long)gold_mult<VAL>(IN[i]), (long long)out[i], (long long)ConstMult<VAL>::tree(IN[i]));
+			return -1;
+		}
+	}
+	return 0;
+}
+
+template <typename T>
+int test_consts(){
+	std::array<T, NUM_TESTS> in = gen_inputs<T>();
+	if(test_const<T, 0>(in) || test_const<T, 1>(in) || test_const<T, -1>(in) ||
+		test_const<T, 2>(in) || test_const<T, 3>(in) || test_const<T, 7>(in) ||
+		test_const<T, 15>(in) || test_const<T, 35>(in) || test_const<T, -35>(in) ||
+		test_const<T, 64>(in) || test_const<T, -64>(in) || test_const<T, 255>(in) ||
+		test_const<T, 0x5555>(in) || test_const<T, 0xAAAA>(in) || test_const<T, 1000003>(in) ||
+		test_const<T, -123456789>(in) || test_const<T, INT_MAX>(in) || test_const<T, INT_MIN>(in)){
+		return -1;
+	}
+	return 0;
+}
+
+// A wider constant than int can hold
+int test_long_consts(){
+	std::array<long long, NUM_TESTS> in = gen_inputs<long long>();
+	if(test_consts<long long>() || test_const<long long, 0x123456789ABLL>(in) ||
+		test_const<long long, -(1LL << 40) + 1>(in) || test_const<long long, 0x5555555555555555LL>(in)){
+		return -1;
+	}
+	return 0;
+}
+
+// Terms and adders for a few constants: CSD never needs more adders than
+// the binary form (nonzero bits - 1)
+template <long long VAL>
+int report_adders(){
+	std::size_t bits = __builtin_popcountll(VAL);
+	std::size_t adders = ConstMult<VAL>::ADDERS;
+	printf("ConstMult<%lld>: %lu binary adders, %lu CSD adders\n", VAL, (unsigned long)(bits - 1), (unsigned long)adders);
+	if(adders > bits - 1){
+		fprintf(stderr, "Error! ConstMult<%lld> uses more adders than the binary form\n", VAL);
+		return -1;
+	}
+	return 0;
+}
+
+int test_adders(){
+	if(report_adders<35>() || report_adders<15>() || report_adders<255>() ||
+		report_adders<0x5555>() || report_adders<0x7777>() || report_adders<1000003>()){
+		return -1;
+	}
+	if(ConstMult<1>::ADDERS != 0 || ConstMult<64>::ADDERS != 0 || ConstMult<0>::ADDERS != 0 ||
+		ConstMult<-1>::ADDERS != 1 || ConstMult<15>::ADDERS != 1){
+		fprintf(stderr, "Error! ConstMult adder counts are incorrect\n");
+		return -1;
+	}
+	// The odd parts of the taps are -3, 1, -5, 1, -1, 3, -3, 1: -6 is a
+	// shift of the tree for -3 (and 2 and 4 are shifts of X itself)
+	std::size_t sum = ConstMult<-6>::ADDERS + ConstMult<1>::ADDERS + ConstMult<-5>::ADDERS +
+		ConstMult<2>::ADDERS + ConstMult<-4>::ADDERS + ConstMult<3>::ADDERS +
+		ConstMult<-3>::ADDERS + ConstMult<4>::ADDERS;
+	printf("ConstMults<%s>: %lu adders, %lu separately\n", "TAPS", (unsigned long)FirTaps::ADDERS, (unsigned long)sum);
+	if(FirTaps::ADDERS != sum - ConstMult<-3>::ADDERS){
+		fprintf(stderr, "Error! ConstMults shares the wrong trees\n");
+		return -1;
+	}
+	return 0;
+}
+
+int test_fir(){
+	const int taps[NUM_TAPS] = {TAPS};
+	std::array<int, LIST_LENGTH> in = genarr<-1000, 1000, LIST_LENGTH>();
+	std::array<int, NUM_TAPS> acc, win;
+	acc.fill(0);
+	win.fill(0);
+	std::array<int, LIST_LENGTH> out = hw_synth_mcm_fir(acc, in);
+	for(std::size_t n = 0; n < LIST_LENGTH; ++n){
+		int gold = 0;
+		for(std::size_t k = 0; k < NUM_TAPS && k <= n; ++k){
+			gold += taps[k] * in[n - k];
+		}
+		// Direct form: the window of the last NUM_TAPS inputs, newest
+		// first, times the taps elementwise
+		win = shiftr(in[n], win);
+		int direct = treereduce<Add, clog2(NUM_TAPS)>(FirTaps()(win));
+		if(out[n] != gold || direct != gold){
+			fprintf(stderr, "Error! FIR returned the incorrect value at index %lu. Gold: %d, Transposed: %d, Direct: %d\n",
+				(unsigned long)n, gold, out[n], direct);
+			return -1;
+		}
+	}
+	printf("MCM FIR (transposed, direct) Test Passed!\n");
+	return 0;
+}
+
+// Keeps the benchmark loops from being optimized away
+volatile unsigned long long bench_sink;
+
+// Host cost of map<MultBy<VAL>> against map<ConstMult<VAL>>, which runs
+// the shift-add tree in C-sim. They are reported, not compared: the
+// timing is too noisy for a pass/fail check. The elements are unsigned, so that the
+// tree's adds wrap like the multiply.
+template <long long VAL>
+int bench(){
+	static std::array<unsigned int, BENCH_LENGTH> in, m, c;
+	std::mt19937 gen(VAL);
+	std::uniform_int_distribution<unsigned int> dist(0, 200000);
+	for(std::size_t i = 0; i < BENCH_LENGTH; ++i){
+		in[i] = dist(gen);
+	}
+	unsigned long long sum = 0;
+	auto start = std::chrono::high_resolution_clock::now();
+	for(std::size_t it = 0; it < BENCH_ITERS; ++it){
+		in[it % BENCH_LENGTH] += 1;
+		m = map<MultBy<VAL>>(in);
+		sum += m[it % BENCH_LENGTH];
+	}
+	auto mid = std::chrono::high_resolution_clock::now();
+	for(std::size_t it = 0; it < BENCH_ITERS; ++it){
+		in[it % BENCH_LENGTH] -= 1;
+		c = map<ConstMult<VAL>>(in);
+		sum += c[it % BENCH_LENGTH];
+	}
+	auto stop = std::chrono::high_resolution_clock::now();
+	if(c != map<MultBy<VAL>>(in)){
+		fprintf(stderr, "Error! ConstMult<%lld> benchmark results differ\n", VAL);
+		return -1;
+	}
+	bench_sink = sum;
+	const double n = BENCH_ITERS * BENCH_LENGTH;
+	printf("ConstMult<%lld> (%lu adders): MultBy %.3f ns/element, ConstMult %.3f ns/element\n",
+		VAL, (unsigned long)ConstMult<VAL>::ADDERS, std::chrono::duration<double>(mid - start).count() * 1e9 / n,
+		std::chrono::duration<double>(stop - mid).count() * 1e9 / n);
+	return 0;
+}
+
+int test_designs(){
+	std::array<int, LIST_LENGTH> in = genarr<-100000, 100000, LIST_LENGTH>();
+	if(hw_synth_constmult(in) != hw_synth_multby(in)){
+		fprintf(stderr, "Error! hw_synth_constmult and hw_synth_multby differ\n");
+		return -1;
+	}
+	return 0;
+}
+
+int main(){
+	int err;
+	if((err = test_consts<int>()) || (err = test_consts<short>()) || (err = test_long_consts())){
+		return err;
+	}
+	printf("ConstMult Test Passed!\n");
+	if((err = test_adders()) || (err = test_fir()) || (err = test_designs())){
+		return err;
+	}
+	if((err = bench<35>()) || (err = bench<0x5555>()) || (err = bench<1000003>())){
+		return err;
+	}
+	printf("ConstMult Tests passed\n");
+	return 0;	
+}
@@ -82,10 +82,10 @@ public:
 // -------------------- Min --------------------
 class Min{
 public:
-	int operator()(std::array<int, 1> L, std::array<int, 1> R){
+	CONSTEXPR17 int operator()(std::array<int, 1> L, std::array<int, 1> R){
 		return L[0] < R[0] ? L[0] : R[0];
 	}
-	int operator()(int L, int R){
+	CONSTEXPR17 int operator()(int L, int R){
 		return L < R ? L : R;
 	}
 };
@@ -411,6 +411,18 @@ int test_argmax(){
 }
 // -------------------- Begin Argmin/Argmax --------------------
 
+// -------------------- Begin Constexpr --------------------
+// Under C++17 divconq can be evaluated at compile time
+int test_constexpr(){
+#if __cplusplus >= 201703L
+	constexpr std::array<int, 8> in = {{5, 3, 9, -4, 7, 0, -2, 8}};
+	static_assert(divconq<Min>(in) == -4, "Constexpr divconq<Min> is incorrect");
+	static_assert(divconq<Min>(reverse(in)) == -4, "Constexpr divconq<Min> is incorrect");
+	printf("Constexpr Divconq Test Passed!\n");
+#endif
+	return 0;
+}
+// -------------------- End Constexpr --------------------
 
 int main(){
 	int err;
@@ -433,6 +445,10 @@ int main(){
 	if((err = test_argmax())){
 		return err;
 	}
+
+	if((err = test_constexpr())){
+		return err;
+	}
 	
 	printf("Divconq tests passed\n");
 	return 0;	
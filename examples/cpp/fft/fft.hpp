@@ -41,7 +41,12 @@
 #include "divconq.hpp"
 #include "reduce.hpp"
 #include "constops.hpp"
+#include "permute.hpp"
+#include "soa.hpp"
+#include "stream.hpp"
+#include "matrix.hpp"
 #include <complex>
+#include <vector>
 #include <stdio.h>
 #ifdef BIT_ACCURATE
 //#include "hls_math.h"
@@ -61,23 +66,11 @@ using twid_t = std::pair<T, T>;
 template <typename T>
 using data_t = std::pair<FFT_t<T>, FFT_t<T>>;
 
-class Interleave{
-public:
-	template <typename T, std::size_t LEN>
-	std::array<T, 2*LEN> operator()(std::array<T, LEN> L, std::array<T, LEN> R){
-#pragma HLS INLINE
-#pragma HLS ARRAY_PARTITION complete VARIABLE=L._M_instance
-#pragma HLS ARRAY_PARTITION complete VARIABLE=R._M_instance
-		std::array<T, 0> init;
-		return rreduce<Merge>(zipWith<Array>(L, R), init);
-	}
-};
-
 template <typename T, std::size_t LEN>
-std::array<T, LEN> bitreverse(std::array<T, LEN> IN){
+std::array<T, LEN> bitreverse(std::array<T, LEN> const& IN){
 #pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
 #pragma HLS INLINE
-	return divconq<Interleave>(IN);
+	return permute<BitReversePerm>(IN);
 }
 
 
@@ -94,12 +87,11 @@ struct CalcAngle{
 template <class FTOR>
 struct NPtFFT{
 	template <typename T, std::size_t LEN>
-	std::array<FFT_t<T>, 2*LEN> operator()(std::array<FFT_t<T>, LEN> L, std::array<FFT_t<T>, LEN> R){
+	std::array<FFT_t<T>, 2*LEN> operator()(std::array<FFT_t<T>, LEN> const& L, std::array<FFT_t<T>, LEN> const& R){
 #pragma HLS INLINE
 		static const size_t LEV = hlog2(LEN)+1;
 		auto twiddles = map<CalcAngle<T, LEV>>(range<LEN>());
-		auto pairs = zip(L, R);
-		auto outputs = unzip(zipWith<FTOR>(twiddles, pairs));
+		auto outputs = unzip(zipWithN<FTOR>(twiddles, L, R));
 		return outputs.first + outputs.second;
 	}
 };
@@ -109,7 +101,14 @@ public:
 	template <typename T> 
 	auto operator()(twid_t<T> const& TWID, data_t<T> const& IN) -> data_t<T>{
 #pragma HLS INLINE
-		FFT_t<T> ti = IN.first, bi = IN.second, to, bo;
+		return (*this)(TWID, IN.first, IN.second);
+	}
+
+	// Butterfly on separate top and bottom inputs, for zipWithN
+	template <typename T> 
+	auto operator()(twid_t<T> const& TWID, FFT_t<T> const& TOP, FFT_t<T> const& BOT) -> data_t<T>{
+#pragma HLS INLINE
+		FFT_t<T> ti = TOP, bi = BOT, to, bo;
 		T c = TWID.first;
 		T s = TWID.second;
 		T temp_r = c*std::real(bi) + s*std::imag(bi);
@@ -122,11 +121,620 @@ public:
 	}
 };
 
+// Multiplies IN by the twiddle TWID, with the convention of FFTOP
+template <typename T>
+FFT_t<T> _twiddleMult(twid_t<T> const& TWID, FFT_t<T> const& IN){
+#pragma HLS INLINE
+	return {TWID.first*IN.real() + TWID.second*IN.imag(), 
+		TWID.first*IN.imag() - TWID.second*IN.real()};
+}
+
+// The twiddle of E/LEN of a turn, in the (cos, sin) form FFTOP expects
+template <typename T>
+twid_t<T> _twiddle(std::size_t E, std::size_t LEN){
+#pragma HLS INLINE
+	return {(T)cos(-2*M_PI*E/LEN), (T)sin(-2*M_PI*E/LEN)};
+}
+
+// Complex multiply forms for twiddles: Mult4 is 4 multiplies and 2 adds;
+// Gauss3 is 3 multiplies and 3 adds, since the twiddle sums C - S and
+// -(C + S) are constants. Gauss3 trades a multiplier (a DSP) for an
+// adder, and rounds slightly differently.
+struct Mult4{};
+struct Gauss3{};
+
+template <typename T>
+FFT_t<T> _complexMult(Mult4, twid_t<T> const& TWID, FFT_t<T> const& IN){
+#pragma HLS INLINE
+	return _twiddleMult(TWID, IN);
+}
+
+template <typename T>
+FFT_t<T> _complexMult(Gauss3, twid_t<T> const& TWID, FFT_t<T> const& IN){
+#pragma HLS INLINE
+	T c = TWID.first, s = TWID.second;
+	T k1 = c*(IN.real() + IN.imag());
+	T k2 = IN.real()*(-(c + s));
+	T k3 = IN.imag()*(c - s);
+	return {k1 - k3, k1 + k2};
+}
+
+// Twiddles of a radix-2 stage (E/LEN of a turn, less than 1/2) that need
+// fewer multiplies: 0 (none), 1/4 (none: a swap and a negation), 1/8
+// and 3/8 (2: both parts of the product are scaled by 1/sqrt(2)); any
+// other twiddle is a full complex multiply
+constexpr std::size_t _twiddleKind(std::size_t E, std::size_t LEN){
+	return (E == 0) ? 0 : (4*E == LEN) ? 1 : (8*E == LEN) ? 2 :
+		(8*E == 3*LEN) ? 3 : 4;
+}
+
+template <std::size_t KIND>
+struct _constTwiddle{
+	template <std::size_t E, std::size_t LEN, class MULT, typename T>
+	static FFT_t<T> mult(FFT_t<T> const& IN){
+#pragma HLS INLINE
+		return _complexMult(MULT(), _twiddle<T>(E, LEN), IN);
+	}
+};
+
+template <>
+struct _constTwiddle<0>{
+	template <std::size_t E, std::size_t LEN, class MULT, typename T>
+	static FFT_t<T> mult(FFT_t<T> const& IN){
+#pragma HLS INLINE
+		return IN;
+	}
+};
+
+template <>
+struct _constTwiddle<1>{
+	template <std::size_t E, std::size_t LEN, class MULT, typename T>
+	static FFT_t<T> mult(FFT_t<T> const& IN){
+#pragma HLS INLINE
+		return {-IN.imag(), IN.real()};
+	}
+};
+
+template <>
+struct _constTwiddle<2>{
+	template <std::size_t E, std::size_t LEN, class MULT, typename T>
+	static FFT_t<T> mult(FFT_t<T> const& IN){
+#pragma HLS INLINE
+		T h = (T)M_SQRT1_2;
+		return {h*(IN.real() - IN.imag()), h*(IN.real() + IN.imag())};
+	}
+};
+
+template <>
+struct _constTwiddle<3>{
+	template <std::size_t E, std::size_t LEN, class MULT, typename T>
+	static FFT_t<T> mult(FFT_t<T> const& IN){
+#pragma HLS INLINE
+		T h = (T)M_SQRT1_2;
+		return {-(h*(IN.real() + IN.imag())), h*(IN.real() - IN.imag())};
+	}
+};
+
+// FFTOP with the twiddle E/LEN of a turn known at compile time, so that
+// trivial twiddles drop (some of) their multiplies; other twiddles are
+// multiplied in the form MULT. NPtFFT<ConstFFTOP<MULT>> passes each
+// butterfly its index.
+template <class MULT = Mult4>
+struct ConstFFTOP{
+	template <std::size_t E, std::size_t LEN, typename T>
+	static data_t<T> butterfly(FFT_t<T> const& TOP, FFT_t<T> const& BOT){
+#pragma HLS INLINE
+		FFT_t<T> p = _constTwiddle<_twiddleKind(E, LEN)>::template mult<E, LEN, MULT>(BOT);
+		return {TOP + p, TOP - p};
+	}
+};
+
+template <class MULT>
+struct NPtFFT<ConstFFTOP<MULT> >{
+	template <typename T, std::size_t LEN>
+	std::array<FFT_t<T>, 2*LEN> operator()(std::array<FFT_t<T>, LEN> const& L, std::array<FFT_t<T>, LEN> const& R){
+#pragma HLS INLINE
+		auto outputs = unzip(_butterflies(L, R, typename _mkidxseq<LEN>::type()));
+		return outputs.first + outputs.second;
+	}
+
+private:
+	template <typename T, std::size_t LEN, std::size_t... E>
+	static std::array<data_t<T>, LEN> _butterflies(std::array<FFT_t<T>, LEN> const& L, std::array<FFT_t<T>, LEN> const& R, _idxseq<E...>){
+#pragma HLS INLINE
+		return {{ConstFFTOP<MULT>::template butterfly<E, 2*LEN>(L[E], R[E])...}};
+	}
+};
+
+// Power-of-two FFT: divconq over NPtFFT, on bit-reversed input. The
+// butterflies have compile-time twiddles, with non-trivial twiddles
+// multiplied in the form MULT (Mult4 or Gauss3).
+template<class MULT = Mult4, typename T, std::size_t LEN>
+std::array<std::complex<T>, LEN> fft_radix2(std::array<std::complex<T>, LEN> const& IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS INLINE
+	return divconq<NPtFFT<ConstFFTOP<MULT> > >(bitreverse(IN));
+}
+
+// Twiddle ROM of the mixed-radix stages: all LEN twiddles of a LEN-point
+// stage, computed once in double precision
+template <typename T, std::size_t LEN>
+struct _mrTwiddles{
+	twid_t<T> rom[LEN];
+
+	_mrTwiddles(){
+		for(std::size_t e = 0; e < LEN; ++e){
+			rom[e] = _twiddle<T>(e, LEN);
+		}
+	}
+};
+
+// DFT of R points, with the sign convention of FFTOP; radix 2 is a
+// butterfly with a unit twiddle. The twiddles come from a ROM, and the
+// unit twiddles (row 0 and column 0) are not multiplied.
+template <std::size_t R>
+struct RadixDFT{
+	template <typename T>
+	std::array<FFT_t<T>, R> operator()(std::array<FFT_t<T>, R> const& IN){
+#pragma HLS INLINE
+		static const _mrTwiddles<T, R> twiddles;
+		std::array<FFT_t<T>, R> out;
+		for(std::size_t q = 0; q < R; ++q){
+#pragma HLS UNROLL
+			out[q] = IN[0];
+			for(std::size_t j = 1; j < R; ++j){
+#pragma HLS UNROLL
+				std::size_t e = (j * q) % R;
+				out[q] += (e == 0) ? IN[j] : _twiddleMult(twiddles.rom[e], IN[j]);
+			}
+		}
+		return out;
+	}
+};
+
+template <>
+struct RadixDFT<2>{
+	template <typename T>
+	std::array<FFT_t<T>, 2> operator()(std::array<FFT_t<T>, 2> const& IN){
+#pragma HLS INLINE
+		data_t<T> o = ConstFFTOP<>::butterfly<0, 2>(IN[0], IN[1]);
+		return {{o.first, o.second}};
+	}
+};
+
+// Stages of a mixed-radix FFT of SIZE points, applied to every SIZE-point
+// block of IO. The inner stages (of SIZE/R points) run first; then each
+// of the SIZE/R radix-R butterflies twiddles its inputs and applies
+// RadixDFT<R>. Input j of butterfly k is twiddled by entry j*k (less than
+// SIZE) of the ROM; input 0 and butterfly 0 have unit twiddles and are
+// not multiplied.
+template <std::size_t SIZE, std::size_t R = _mrRadix(SIZE)>
+struct _mrHelp{
+	template <typename T, std::size_t LEN>
+	static void stages(std::array<FFT_t<T>, LEN>& IO){
+#pragma HLS INLINE
+		static const std::size_t S = SIZE / R;
+		static const _mrTwiddles<T, SIZE> twiddles;
+		_mrHelp<S>::stages(IO);
+	HOPS_LABEL(mr_block)
+		for(std::size_t b = 0; b < LEN; b += SIZE){
+#pragma HLS UNROLL
+		HOPS_LABEL(mr_bfly)
+			for(std::size_t k = 0; k < S; ++k){
+#pragma HLS UNROLL
+				std::array<FFT_t<T>, R> x;
+				x[0] = IO[b + k];
+				for(std::size_t j = 1; j < R; ++j){
+#pragma HLS UNROLL
+					x[j] = (k == 0) ? IO[b + j * S] : _twiddleMult(twiddles.rom[j * k], IO[b + k + j * S]);
+				}
+				x = RadixDFT<R>()(x);
+				for(std::size_t j = 0; j < R; ++j){
+#pragma HLS UNROLL
+					IO[b + k + j * S] = x[j];
+				}
+			}
+		}
+	}
+};
+
+template <>
+struct _mrHelp<1, 1>{
+	template <typename T, std::size_t LEN>
+	static void stages(std::array<FFT_t<T>, LEN>&){
+#pragma HLS INLINE
+	}
+};
+
+// Mixed-radix FFT, for LEN = 2^a * 3^b * 5^c: digit reversal, then one
+// stage per factor of LEN. Any other prime factor P of LEN becomes a
+// direct P-point DFT stage.
+template<typename T, std::size_t LEN>
+std::array<std::complex<T>, LEN> fft_mixed(std::array<std::complex<T>, LEN> const& IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS INLINE
+	std::array<FFT_t<T>, LEN> io = permute<DigitReversePerm>(IN);
+#pragma HLS ARRAY_PARTITION complete VARIABLE=io._M_instance
+	_mrHelp<LEN>::stages(io);
+	return io;
+}
+
+// The chirp of the Bluestein FFT, b[n] = exp(i*pi*n^2/LEN) in the
+// convention of FFTOP. n^2 is reduced modulo 2*LEN first, so that the
+// angle stays exact for large n.
+template <typename T>
+twid_t<T> _chirp(std::size_t N, std::size_t LEN){
+#pragma HLS INLINE
+	return _twiddle<T>((N * N) % (2 * LEN), 2 * LEN);
+}
+
+// Transform of the conjugate chirp, zero-padded and wrapped to M points
+template <typename T, std::size_t LEN, std::size_t M>
+std::array<FFT_t<T>, M> _bluesteinFilter(){
+	std::array<FFT_t<T>, M> h{};
+	for(std::size_t m = 0; m < LEN; ++m){
+		twid_t<T> b = _chirp<T>(m, LEN);
+		h[m] = {b.first, b.second};
+		if(m > 0){
+			h[M - m] = h[m];
+		}
+	}
+	return fft_radix2(h);
+}
+
+// Bluestein (chirp-z) FFT for any LEN. With the chirp b, n*k = (n^2 + k^2
+// - (k-n)^2)/2 gives X[k] = b[k] * sum_n (x[n] b[n]) conj(b[k-n]), a
+// convolution, computed with M-point power-of-two FFTs for M >= 2*LEN-1.
+// The transform of conj(b) is a constant (a ROM), and the inverse FFT is
+// conj(fft(conj(Y)))/M.
+template<typename T, std::size_t LEN>
+std::array<std::complex<T>, LEN> fft_bluestein(std::array<std::complex<T>, LEN> const& IN){
+	static const std::size_t M = 1 << clog2(2 * LEN - 1);
+	static const std::array<FFT_t<T>, M> H = _bluesteinFilter<T, LEN, M>();
+	std::array<FFT_t<T>, M> a{};
+	for(std::size_t n = 0; n < LEN; ++n){
+#pragma HLS UNROLL
+		a[n] = _twiddleMult(_chirp<T>(n, LEN), IN[n]);
+	}
+	a = fft_radix2(a);
+	for(std::size_t m = 0; m < M; ++m){
+#pragma HLS UNROLL
+		a[m] = std::conj(a[m] * H[m]);
+	}
+	a = fft_radix2(a);
+	std::array<FFT_t<T>, LEN> out;
+	for(std::size_t k = 0; k < LEN; ++k){
+#pragma HLS UNROLL
+		out[k] = _twiddleMult(_chirp<T>(k, LEN), std::conj(a[k])) / (T)M;
+	}
+	return out;
+}
+
+constexpr bool _smooth235(std::size_t LEN){
+	return (LEN <= 1) || (_mrRadix(LEN) <= 5 && _smooth235(LEN / _mrRadix(LEN)));
+}
+
+// KIND is 2 (LEN is a power of two), 235 (a product of 2, 3 and 5), or 0
+template <std::size_t KIND>
+struct _fftSize;
+
+template <>
+struct _fftSize<2>{
+	template <typename T, std::size_t LEN>
+	static std::array<FFT_t<T>, LEN> fft(std::array<FFT_t<T>, LEN> const& IN){
+#pragma HLS INLINE
+		return fft_radix2(IN);
+	}
+};
+
+template <>
+struct _fftSize<235>{
+	template <typename T, std::size_t LEN>
+	static std::array<FFT_t<T>, LEN> fft(std::array<FFT_t<T>, LEN> const& IN){
+#pragma HLS INLINE
+		return fft_mixed(IN);
+	}
+};
+
+template <>
+struct _fftSize<0>{
+	template <typename T, std::size_t LEN>
+	static std::array<FFT_t<T>, LEN> fft(std::array<FFT_t<T>, LEN> const& IN){
+#pragma HLS INLINE
+		return fft_bluestein(IN);
+	}
+};
+
+// fft(IN) picks the engine from LEN: fft_radix2 for powers of two,
+// fft_mixed for other products of 2, 3 and 5 (e.g. 1536 = 3 * 2^9), and
+// fft_bluestein for everything else, so no size has to be zero-padded
 template<typename T, std::size_t LEN>
-std::array<std::complex<T>, LEN>fft(std::array<std::complex<T>, LEN> IN){
+std::array<std::complex<T>, LEN> fft(std::array<std::complex<T>, LEN> const& IN){
 #pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
 #pragma HLS INLINE
-	return divconq<NPtFFT<FFTOP>>(bitreverse(IN));
+	return _fftSize<((LEN & (LEN - 1)) == 0) ? 2 : _smooth235(LEN) ? 235 : 0>::fft(IN);
+}
+
+struct FFT{
+	template <typename T, std::size_t LEN>
+	std::array<FFT_t<T>, LEN> operator()(std::array<FFT_t<T>, LEN> const& IN){
+#pragma HLS INLINE
+		return fft(IN);
+	}
+};
+
+// Complex lists can also be stored as separate real and imaginary planes,
+// so each plane can be partitioned (or vectorized) on its own
+template <typename T, std::size_t LEN>
+using split_complex_t = soa_array<LEN, T, T>;
+
+struct Real{
+	template <typename T>
+	T operator()(FFT_t<T> const& IN){
+#pragma HLS INLINE
+		return IN.real();
+	}
+};
+
+struct Imag{
+	template <typename T>
+	T operator()(FFT_t<T> const& IN){
+#pragma HLS INLINE
+		return IN.imag();
+	}
+};
+
+struct MakeComplex{
+	template <typename T>
+	FFT_t<T> operator()(T const& RE, T const& IM){
+#pragma HLS INLINE
+		return {RE, IM};
+	}
+};
+
+template <typename T, std::size_t LEN>
+split_complex_t<T, LEN> to_planes(std::array<FFT_t<T>, LEN> const& IN){
+#pragma HLS INLINE
+	return zip_soa(map<Real>(IN), map<Imag>(IN));
+}
+
+template <typename T, std::size_t LEN>
+std::array<FFT_t<T>, LEN> from_planes(split_complex_t<T, LEN> const& IN){
+#pragma HLS INLINE
+	return map<MakeComplex>(IN);
+}
+
+template<typename T, std::size_t LEN>
+split_complex_t<T, LEN> fft(split_complex_t<T, LEN> const& IN){
+#pragma HLS INLINE
+	return to_planes(fft(from_planes(IN)));
+}
+
+// Memory-based (folded) FFT, with P butterfly units reused over every
+// stage. fft<folded<P>>(IN) computes the same result as fft(IN), in
+// LEN/P + hlog2(LEN)*LEN/(2*P) + LEN/P cycles (load, stages, store), so
+// throughput scales with P while the storage stays at two frames (ping
+// and pong) plus a LEN/2-entry twiddle ROM. This is the form to use past
+// a few hundred points, where fft(IN) no longer fits.
+//
+// The stages use the constant-geometry (Pease) schedule: every stage
+// reads points 2J and 2J+1 of one buffer, and FFTOP writes points J and
+// J+LEN/2 of the other. Each frame is stored in 2*P banks, and point I
+// lives in bank (I + P*H) % (2*P), where H is the top bit of I, at
+// address I/(2*P). In one cycle the P butterflies read 2*P consecutive
+// points (every bank once), and write P consecutive points in each half
+// of the frame (one half of the banks each), so no bank is accessed
+// twice.
+template <typename T, std::size_t LEN, std::size_t P>
+struct _fftBanks{
+	static_assert(LEN >= 4*P && (LEN & (LEN - 1)) == 0 && (P & (P - 1)) == 0, 
+		"LEN and P must be powers of two, with LEN >= 4*P");
+	static constexpr std::size_t BANKS = 2*P;
+	FFT_t<T> mem[BANKS][LEN/BANKS];
+
+	static constexpr std::size_t bank(std::size_t I){
+		return (I + ((I >= LEN/2) ? P : 0)) % BANKS;
+	}
+
+	static constexpr std::size_t addr(std::size_t I){
+		return I / BANKS;
+	}
+
+	FFT_t<T>& operator[](std::size_t I){
+#pragma HLS INLINE
+		return mem[bank(I)][addr(I)];
+	}
+};
+
+// Twiddle ROM of the folded FFT, computed once in double precision. Stage
+// S uses entry (J >> (LEV-1-S)) << (LEV-1-S) for butterfly J, so the P
+// butterflies of one cycle read either the same entry, or entries that
+// are different modulo P; the ROM is partitioned cyclically by P.
+template <typename T, std::size_t LEN>
+struct _fftTwiddles{
+	twid_t<T> rom[LEN/2];
+
+	_fftTwiddles(){
+		for(std::size_t e = 0; e < LEN/2; ++e){
+			rom[e] = _twiddle<T>(e, LEN);
+		}
+	}
+};
+
+template <class FTOR, typename T, std::size_t LEN, std::size_t P>
+void _foldedStage(_fftBanks<T, LEN, P>& SRC, _fftBanks<T, LEN, P>& DST, 
+		_fftTwiddles<T, LEN> const& TW, std::size_t S){
+#pragma HLS INLINE
+	static const std::size_t LEV = hlog2(LEN);
+	std::size_t shift = LEV - 1 - S;
+HOPS_LABEL(bfly_pair)
+	for(std::size_t j = 0; j < LEN/2; ++j){
+#pragma HLS PIPELINE
+#pragma HLS UNROLL factor=P
+#pragma HLS DEPENDENCE variable=DST.mem inter false
+		data_t<T> o = FTOR()(TW.rom[(j >> shift) << shift], SRC[2*j], SRC[2*j + 1]);
+		DST[j] = o.first;
+		DST[j + LEN/2] = o.second;
+	}
+}
+
+template <class POLICY>
+struct _fftPolicy;
+
+template <>
+struct _fftPolicy<unrolled>{
+	template <typename T, std::size_t LEN>
+	static std::array<FFT_t<T>, LEN> fft(std::array<FFT_t<T>, LEN> const& IN){
+#pragma HLS INLINE
+		return ::fft(IN);
+	}
+};
+
+template <std::size_t P>
+struct _fftPolicy<folded<P> >{
+	template <typename T, std::size_t LEN>
+	static std::array<FFT_t<T>, LEN> fft(std::array<FFT_t<T>, LEN> const& IN){
+		// The P bit-reversed indices loaded in one cycle are LEN/P apart,
+		// i.e. one in each block of IN
+#pragma HLS ARRAY_PARTITION block factor=P VARIABLE=IN._M_instance
+		static const std::size_t LEV = hlog2(LEN);
+		// The banks are too large for the stack of a host thread, so they
+		// are static. In C-sim every thread gets its own pair, so that
+		// several threads can run folded FFTs at once.
+#ifdef __SYNTHESIS__
+		static _fftBanks<T, LEN, P> ping, pong;
+#else
+		static thread_local _fftBanks<T, LEN, P> ping, pong;
+#endif
+#pragma HLS ARRAY_PARTITION complete dim=1 VARIABLE=ping.mem
+#pragma HLS ARRAY_PARTITION complete dim=1 VARIABLE=pong.mem
+		static const _fftTwiddles<T, LEN> twiddles;
+#pragma HLS ARRAY_PARTITION cyclic factor=P VARIABLE=twiddles.rom
+		std::array<FFT_t<T>, LEN> OUT;
+#pragma HLS ARRAY_PARTITION cyclic factor=P VARIABLE=OUT._M_instance
+	HOPS_LABEL(load)
+		for(std::size_t i = 0; i < LEN; ++i){
+#pragma HLS PIPELINE
+#pragma HLS UNROLL factor=P
+			ping[i] = IN[_brev(i, LEV)];
+		}
+	HOPS_LABEL(stage)
+		for(std::size_t s = 0; s < LEV; ++s){
+			if(s & 1){
+				_foldedStage<FFTOP>(pong, ping, twiddles, s);
+			} else {
+				_foldedStage<FFTOP>(ping, pong, twiddles, s);
+			}
+		}
+		_fftBanks<T, LEN, P>& res = (LEV & 1) ? pong : ping;
+	HOPS_LABEL(store)
+		for(std::size_t i = 0; i < LEN; ++i){
+#pragma HLS PIPELINE
+#pragma HLS UNROLL factor=P
+			OUT[i] = res[i];
+		}
+		return OUT;
+	}
+};
+
+template <>
+struct _fftPolicy<streaming> : _fftPolicy<folded<1> >{};
+
+// fft<POLICY>(IN) computes the same result as fft(IN), using the
+// execution policy POLICY (see policy.hpp): folded<P> and streaming build
+// the memory-based FFT above
+template <class POLICY, typename T, std::size_t LEN>
+std::array<FFT_t<T>, LEN> fft(std::array<FFT_t<T>, LEN> const& IN){
+#pragma HLS INLINE
+	return _fftPolicy<POLICY>::fft(IN);
+}
+
+// Bailey's four-step FFT of N1*N2 points, built from the small fft()
+// kernels of N1 and N2 points. With n = n1 + N1*n2 and k = N2*k1 + k2:
+//
+//   1. N1 FFTs of size N2, over n2 (one for each n1)
+//   2. multiply point (n1, k2) by the twiddle of n1*k2 (of N1*N2 points)
+//   3. transpose
+//   4. N2 FFTs of size N1, over n1 (one for each k2)
+//
+// The transposes before step 1 and after step 4 (the six-step form) keep
+// the input and output in natural order. In the streaming engine all
+// three transposes are corner turns: they are the order in which two
+// frame buffers (2*N1*N2 points) are written and read.
+template <std::size_t N1, std::size_t N2, typename T, std::size_t DEPTH>
+void fft_fourstep(stream<FFT_t<T>, DEPTH>& IN, stream<FFT_t<T>, DEPTH>& OUT){
+	static const std::size_t LEN = N1*N2;
+	static FFT_t<T> a[N1][N2], b[N2][N1];
+	static const _fftTwiddles<T, LEN> twiddles;
+HOPS_LABEL(load)
+	for(std::size_t n2 = 0; n2 < N2; ++n2){
+		for(std::size_t n1 = 0; n1 < N1; ++n1){
+#pragma HLS PIPELINE
+			a[n1][n2] = IN.read();
+		}
+	}
+HOPS_LABEL(row_fft)
+	for(std::size_t n1 = 0; n1 < N1; ++n1){
+#pragma HLS PIPELINE
+		std::array<FFT_t<T>, N2> row;
+		for(std::size_t k = 0; k < N2; ++k){
+			row[k] = a[n1][k];
+		}
+		row = fft(row);
+		for(std::size_t k2 = 0; k2 < N2; ++k2){
+			// The ROM covers half a turn; the other half is its negation
+			std::size_t m = n1*k2;
+			twid_t<T> w = twiddles.rom[m % (LEN/2)];
+			if(m >= LEN/2){
+				w = {-w.first, -w.second};
+			}
+			b[k2][n1] = _twiddleMult(w, row[k2]);
+		}
+	}
+HOPS_LABEL(col_fft)
+	for(std::size_t k2 = 0; k2 < N2; ++k2){
+#pragma HLS PIPELINE
+		std::array<FFT_t<T>, N1> col;
+		for(std::size_t k = 0; k < N1; ++k){
+			col[k] = b[k2][k];
+		}
+		col = fft(col);
+		for(std::size_t k1 = 0; k1 < N1; ++k1){
+			a[k1][k2] = col[k1];
+		}
+	}
+HOPS_LABEL(store)
+	for(std::size_t k1 = 0; k1 < N1; ++k1){
+		for(std::size_t k2 = 0; k2 < N2; ++k2){
+#pragma HLS PIPELINE
+			OUT.write(a[k1][k2]);
+		}
+	}
+}
+
+// 2-D FFT of an R x C tile: the row pass maps fft over the R rows, a
+// corner turn hands the results to the column pass as C columns, and the
+// column pass maps fft over the columns. Both passes are pipelined, one
+// row (or column) per cycle, and the corner turn is banked (see
+// corner_turn) so that each cycle writes one full row and reads one full
+// column without a stall. The output is row-major, like the input.
+template <typename T, std::size_t R, std::size_t C>
+std::array<std::array<FFT_t<T>, C>, R> fft2d(std::array<std::array<FFT_t<T>, C>, R> const& IN){
+	std::array<std::array<FFT_t<T>, C>, R> rows = map<FFT, streaming>(IN);
+	corner_turn<FFT_t<T>, R, C> ct;
+#pragma HLS ARRAY_PARTITION complete dim=1 VARIABLE=ct.banks
+	std::array<std::array<FFT_t<T>, R>, C> cols;
+HOPS_LABEL(row_turn)
+	for(std::size_t r = 0; r < R; ++r){
+#pragma HLS PIPELINE
+		ct.write_row(r, rows[r]);
+	}
+HOPS_LABEL(col_turn)
+	for(std::size_t c = 0; c < C; ++c){
+#pragma HLS PIPELINE
+		cols[c] = ct.read_col(c);
+	}
+	return transpose(map<FFT, streaming>(cols));
 }
 
 namespace imperative{
@@ -153,7 +761,7 @@ namespace imperative{
 	}
 
 	template <class FTOR, std::size_t LEN, typename T>
-	std::array<FFT_t<T>, LEN> _butterfly(std::array<FFT_t<T>, LEN> IN){
+	std::array<FFT_t<T>, LEN> _butterfly(std::array<FFT_t<T>, LEN> const& IN){
 #pragma HLS INLINE
 		static const int LEV = hlog2(LEN);
 		std::array<std::array<FFT_t<T>, LEN>, LEV + 1> stagearr;
@@ -161,12 +769,12 @@ namespace imperative{
 #pragma HLS ARRAY_PARTITION complete VARIABLE=stagearr._M_instance[0]
 #pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
 		stagearr[0]  = IN;
-	bfly_level:
+	HOPS_LABEL(bfly_level)
 		for(std::size_t l = 0; l < LEV; ++l){
 #pragma HLS UNROLL
 			std::size_t stride = 1<<l;
 			std::size_t mask = stride - 1;
-		bfly_pair:
+		HOPS_LABEL(bfly_pair)
 			for(std::size_t i = 0; i < (1 << (LEV - 1)); ++i){
 #pragma HLS UNROLL
 				std::size_t grp = i >> l;
@@ -186,7 +794,7 @@ namespace imperative{
 	}
 
 	template<typename T, std::size_t LEN>
-	std::array<std::complex<T>, LEN> fft(std::array<std::complex<T>, LEN> IN){
+	std::array<std::complex<T>, LEN> fft(std::array<std::complex<T>, LEN> const& IN){
 #pragma HLS INLINE
 #pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
 		auto res = _butterfly<FFTOP>(bitreverse(IN));
@@ -213,50 +821,243 @@ namespace software{
 		}
 	}
 
+	// Host FFT engine, used as the golden model. A plan holds the tables
+	// for one (T, LEN): the bit-reverse permutation, and the twiddles of
+	// every stage stored as split real/imaginary planes, computed once in
+	// double precision. Plans are cached, so get() builds the plan on
+	// first use and returns the same instance afterwards.
+	//
+	// Frames are transformed as split real/imaginary planes, so the inner
+	// butterfly loop runs over contiguous data and twiddles and can be
+	// vectorized by the compiler. The twiddles use the same convention as
+	// FFTOP and CalcAngle.
 	template <typename T, std::size_t LEN>
-	std::array<std::complex<T>, LEN> fft(std::array<std::complex<T>, LEN> IN) {
-		std::complex<T> temp;
-		int stage, fftid, fftidx, pairidx; // Loop Indicies
-		int npts, offset;
-
-		bitreverse(IN);
-
-		T a, e, c, s;
-		int counter;
-	stages:for(stage=1; stage<= hlog2(LEN); stage++)
-		{
-			// Number of points in an FFT = 2^stage
-			npts = 1 << stage;
-			// Offset to the index of the input pair
-			offset = npts/2;
-
-			e = (T)M_PI*-2/npts;
-
-			a = 0.0;
-			counter =0;
-			// Perform fft's for j-th stage
-		ffts:for(fftid=0; fftid<offset; fftid++)
-			{
-				c = cos(a);
-				s = sin(a);
-				// Compute butterflies that use same W**k
-			NPtFFT:for(fftidx=fftid; fftidx<LEN; fftidx += npts)
-				{
-					counter ++;
-					pairidx = fftidx + offset;
-					temp = {IN[pairidx].real()*c+ IN[pairidx].imag()*s, 
-						IN[pairidx].imag()*c- IN[pairidx].real()*s};
-
-					IN[pairidx] = {IN[fftidx].real() - temp.real(), 
-						       IN[fftidx].imag() - temp.imag()};
-					IN[fftidx] = {IN[fftidx].real() + temp.real(), 
-						      IN[fftidx].imag() + temp.imag()};
+	class fft_plan{
+		static_assert(LEN >= 2 && (LEN & (LEN - 1)) == 0, "LEN must be a power of two");
+		std::vector<std::size_t> _rev;
+		// The twiddles for the stage with butterfly span M start at M - 1
+		std::vector<T> _wre, _wim;
+
+		fft_plan() : _rev(LEN), _wre(LEN - 1), _wim(LEN - 1){
+			for(std::size_t i = 0; i < LEN; ++i){
+				_rev[i] = _brev(i, hlog2(LEN));
+			}
+			for(std::size_t m = 1; m < LEN; m <<= 1){
+				for(std::size_t k = 0; k < m; ++k){
+					double a = -M_PI * k / m;
+					_wre[m - 1 + k] = (T)std::cos(a);
+					_wim[m - 1 + k] = (T)std::sin(a);
 				}
-				a = a + e;
 			}
 		}
+
+	public:
+		fft_plan(fft_plan const&) = delete;
+		fft_plan& operator=(fft_plan const&) = delete;
+
+		static fft_plan const& get(){
+			static const fft_plan plan;
+			return plan;
+		}
+
+		// Transforms one frame, stored as split planes, in place
+		void execute(T* RE, T* IM) const{
+			for(std::size_t i = 0; i < LEN; ++i){
+				std::size_t j = _rev[i];
+				if(i < j){
+					std::swap(RE[i], RE[j]);
+					std::swap(IM[i], IM[j]);
+				}
+			}
+			for(std::size_t m = 1; m < LEN; m <<= 1){
+				const T* wr = &_wre[m - 1];
+				const T* wi = &_wim[m - 1];
+				for(std::size_t b = 0; b < LEN; b += 2 * m){
+					T* xr = RE + b;
+					T* xi = IM + b;
+					T* yr = xr + m;
+					T* yi = xi + m;
+					for(std::size_t k = 0; k < m; ++k){
+						T tr = wr[k] * yr[k] + wi[k] * yi[k];
+						T ti = wr[k] * yi[k] - wi[k] * yr[k];
+						yr[k] = xr[k] - tr;
+						yi[k] = xi[k] - ti;
+						xr[k] = xr[k] + tr;
+						xi[k] = xi[k] + ti;
+					}
+				}
+			}
+		}
+
+		void execute(split_complex_t<T, LEN>& IO) const{
+			execute(IO.template get<0>().data(), IO.template get<1>().data());
+		}
+
+		// Transforms one frame in place, through split planes
+		void execute(std::array<FFT_t<T>, LEN>& IO) const{
+			std::vector<T> re(LEN), im(LEN);
+			execute(IO, re.data(), im.data());
+		}
+
+		// Transforms FRAMES frames in place. The frames are spread across
+		// host threads, and each thread reuses one pair of split planes.
+		// An empty batch (FRAMES == 0) does nothing.
+		void execute_batch(std::array<FFT_t<T>, LEN>* IO, std::size_t FRAMES) const{
+			if(FRAMES == 0){
+				return;
+			}
+#ifdef __SYNTHESIS__
+			for(std::size_t f = 0; f < FRAMES; ++f){
+				execute(IO[f]);
+			}
+#else
+			std::size_t n = _host_threads(FRAMES);
+			std::size_t chunk = (FRAMES + n - 1) / n;
+			_host_parallel_for(n, [&](std::size_t t){
+					std::vector<T> re(LEN), im(LEN);
+					for(std::size_t f = t * chunk; f < (t + 1) * chunk && f < FRAMES; ++f){
+						execute(IO[f], re.data(), im.data());
+					}
+				});
+#endif
+		}
+
+	private:
+		void execute(std::array<FFT_t<T>, LEN>& IO, T* RE, T* IM) const{
+			for(std::size_t i = 0; i < LEN; ++i){
+				RE[i] = IO[i].real();
+				IM[i] = IO[i].imag();
+			}
+			execute(RE, IM);
+			for(std::size_t i = 0; i < LEN; ++i){
+				IO[i] = {RE[i], IM[i]};
+			}
+		}
+	};
+
+	// Out-of-place transpose of the R x C row-major matrix IN into the
+	// C x R matrix OUT, in BLOCK x BLOCK tiles so that both sides of a tile
+	// stay in cache. By default a tile row is one 64-byte cache line:
+	// larger tiles touch more lines at the same power-of-two stride, and
+	// evict each other. The rows of tiles are spread across host threads.
+	template <std::size_t R, std::size_t C, typename T, 
+		  std::size_t BLOCK = (sizeof(T) < 64 ? 64 / sizeof(T) : 1)>
+	void transpose_blocked(T const* IN, T* OUT){
+		auto tiles = [=](std::size_t t){
+			std::size_t i0 = t * BLOCK;
+			for(std::size_t j0 = 0; j0 < C; j0 += BLOCK){
+				for(std::size_t i = i0; i < i0 + BLOCK && i < R; ++i){
+					for(std::size_t j = j0; j < j0 + BLOCK && j < C; ++j){
+						OUT[j * R + i] = IN[i * C + j];
+					}
+				}
+			}
+		};
+#ifdef __SYNTHESIS__
+		for(std::size_t t = 0; t < (R + BLOCK - 1) / BLOCK; ++t){
+			tiles(t);
+		}
+#else
+		_host_parallel_for((R + BLOCK - 1) / BLOCK, tiles);
+#endif
+	}
+
+	// Host engine for fft_fourstep (see above), for transforms too large
+	// for one fft_plan to stay in cache. Each step works on rows of N1 or
+	// N2 contiguous points, with KERNEL (an FFT functor, ::FFT by default)
+	// as the row FFT; rows are spread across host threads, and the
+	// transposes are cache-blocked. The plan caches the N1*N2 twiddles of
+	// step 2, computed in double precision, in the order they are used.
+	template <typename T, std::size_t N1, std::size_t N2, class KERNEL = ::FFT>
+	class fft_fourstep_plan{
+		static const std::size_t LEN = N1*N2;
+		std::vector<twid_t<T> > _tw;
+
+		fft_fourstep_plan() : _tw(LEN){
+			for(std::size_t n1 = 0; n1 < N1; ++n1){
+				for(std::size_t k2 = 0; k2 < N2; ++k2){
+					double a = -2 * M_PI * n1 * k2 / LEN;
+					_tw[n1 * N2 + k2] = {(T)std::cos(a), (T)std::sin(a)};
+				}
+			}
+		}
+
+		template <class FN>
+		static void _rows(std::size_t ROWS, FN const& F){
+#ifdef __SYNTHESIS__
+			for(std::size_t r = 0; r < ROWS; ++r){
+				F(r);
+			}
+#else
+			_host_parallel_for(ROWS, F);
+#endif
+		}
+
+	public:
+		fft_fourstep_plan(fft_fourstep_plan const&) = delete;
+		fft_fourstep_plan& operator=(fft_fourstep_plan const&) = delete;
+
+		static fft_fourstep_plan const& get(){
+			static const fft_fourstep_plan plan;
+			return plan;
+		}
+
+		// Transforms the N1*N2 points at IO in place
+		void execute(FFT_t<T>* IO) const{
+			std::vector<FFT_t<T> > scratch(LEN);
+			FFT_t<T>* s = scratch.data();
+			transpose_blocked<N2, N1>(IO, s);
+			_rows(N1, [&](std::size_t n1){
+					std::array<FFT_t<T>, N2> row;
+					std::copy(s + n1 * N2, s + (n1 + 1) * N2, row.begin());
+					row = KERNEL()(row);
+					for(std::size_t k2 = 0; k2 < N2; ++k2){
+						s[n1 * N2 + k2] = _twiddleMult(_tw[n1 * N2 + k2], row[k2]);
+					}
+				});
+			transpose_blocked<N1, N2>(s, IO);
+			_rows(N2, [&](std::size_t k2){
+					std::array<FFT_t<T>, N1> row;
+					std::copy(IO + k2 * N1, IO + (k2 + 1) * N1, row.begin());
+					row = KERNEL()(row);
+					std::copy(row.begin(), row.end(), s + k2 * N1);
+				});
+			transpose_blocked<N2, N1>(s, IO);
+		}
+	};
+
+	// Transforms the N1*N2 points of IO in place, with the four-step FFT
+	template <std::size_t N1, std::size_t N2, class KERNEL = ::FFT, typename T>
+	void fft_fourstep(std::array<FFT_t<T>, N1*N2>& IO){
+		fft_fourstep_plan<T, N1, N2, KERNEL>::get().execute(IO.data());
+	}
+
+	// Transforms IO in place
+	template <typename T, std::size_t LEN>
+	void fft_inplace(std::array<std::complex<T>, LEN>& IO) {
+		fft_plan<T, LEN>::get().execute(IO);
+	}
+
+	template <typename T, std::size_t LEN>
+	std::array<std::complex<T>, LEN> fft(std::array<std::complex<T>, LEN> IN) {
+		fft_inplace(IN);
 		return IN;
 	}
+
+	struct FFT{
+		template <typename T, std::size_t LEN>
+		std::array<FFT_t<T>, LEN> operator()(std::array<FFT_t<T>, LEN> const& IN){
+			return fft(IN);
+		}
+	};
+
+	template <typename T, std::size_t LEN>
+	void fft_batch(std::array<std::complex<T>, LEN>* IO, std::size_t FRAMES) {
+		if(FRAMES == 0){
+			return;
+		}
+		fft_plan<T, LEN>::get().execute_batch(IO, FRAMES);
+	}
 }
 
 #endif
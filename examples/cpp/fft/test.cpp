@@ -38,12 +38,33 @@
 #include <stdio.h>
 #include <complex>
 #include <cmath>
+#include <chrono>
+#include <vector>
+#include <bitset>
+#include <thread>
 #ifdef BIT_ACCURATE
 #include "hls_math.h"
 #include "ap_fixed.h"
 #endif
 #define LOG_LIST_LENGTH 6
 #define LIST_LENGTH (1<<LOG_LIST_LENGTH)
+#define LOG_BENCH_LENGTH 12
+#define BENCH_LENGTH (1<<LOG_BENCH_LENGTH)
+#define BENCH_ITERS 20
+#define BATCH_FRAMES 256
+#define STREAM_DEPTH 1024
+#define FOLDED_P 4
+#define LOG_LARGE_LENGTH 16
+#define LARGE_LENGTH (1<<LOG_LARGE_LENGTH)
+#define LARGE_ROOT (1<<(LOG_LARGE_LENGTH/2))
+#define LOG_HUGE_LENGTH 20
+#define HUGE_LENGTH (1<<LOG_HUGE_LENGTH)
+#define HUGE_ROOT (1<<(LOG_HUGE_LENGTH/2))
+#define LIST_ROOT (1<<(LOG_LIST_LENGTH/2))
+#define TILE_ROWS 16
+#define TILE_COLS 32
+#define MIXED_LENGTH 1536
+#define PADDED_LENGTH 2048
 #ifdef BIT_ACCURATE
 #define DTYPE float
 #else 
@@ -100,11 +121,42 @@ int test_fft(){
 	}
 	printf("FFT (for) test passed!\n");
 
+	split_complex_t<DTYPE, LIST_LENGTH> planes = fft(to_planes(in));
+	if(from_planes(to_planes(in)) != in){
+		fprintf(stderr, "Error! Split-complex planes did not round-trip\n");
+		return -1;
+	}
+	for(int i = 0; i < LIST_LENGTH; i ++){
+		if(std::abs(float(gold[i].real() - planes.get<0>()[i])) > 1 ||
+			std::abs(float(gold[i].imag() - planes.get<1>()[i])) > 1){
+			fprintf(stderr, "Error! Split-complex FFT Values at index %d did not match\n", i);
+			return -1;
+		}
+	}
+	printf("FFT (split-complex) test passed!\n");
+
 	printf("FFT Tests Passed!\n");
 	return 0;
 }
 
 
+std::array<std::complex<DTYPE>, LIST_LENGTH> hw_synth_folded_fft(std::array<std::complex<DTYPE>, LIST_LENGTH> input){
+	return fft<folded<FOLDED_P> >(input);
+}
+
+void hw_synth_fourstep(stream<std::complex<DTYPE> >& IN, stream<std::complex<DTYPE> >& OUT){
+#pragma HLS INTERFACE axis port=IN
+#pragma HLS INTERFACE axis port=OUT
+	fft_fourstep<LIST_ROOT, LIST_ROOT>(IN, OUT);
+}
+
+template <typename T, std::size_t R, std::size_t C>
+using tile_t = std::array<std::array<std::complex<T>, C>, R>;
+
+tile_t<DTYPE, TILE_ROWS, TILE_COLS> hw_synth_fft2d(tile_t<DTYPE, TILE_ROWS, TILE_COLS> input){
+	return fft2d(input);
+}
+
 std::array<FFT_t<DTYPE>, 2*LIST_LENGTH> 
 hw_synth_for_nptfft(std::array<FFT_t<DTYPE>, LIST_LENGTH> L, 
 		std::array<FFT_t<DTYPE>, LIST_LENGTH> R){
@@ -146,6 +198,18 @@ std::array<std::complex<DTYPE>, 2*LIST_LENGTH> hw_synth_nptfft(std::array<std::c
 	return NPtFFT<FFTOP>()(L, R);
 }
 
+// Largest error of OUT against GOLD, relative to the largest magnitude in
+// GOLD
+template <std::size_t LEN>
+double max_rel_err(std::array<std::complex<DTYPE>, LEN> const& GOLD, std::array<std::complex<DTYPE>, LEN> const& OUT){
+	double err = 0, mag = 0;
+	for(std::size_t i = 0; i < LEN; ++i){
+		err = std::max(err, (double)std::abs(GOLD[i] - OUT[i]));
+		mag = std::max(mag, (double)std::abs(GOLD[i]));
+	}
+	return err / mag;
+}
+
 int test_nptfft(){
 	std::array<std::complex<DTYPE>, LIST_LENGTH> l, r;
 	std::array<std::complex<DTYPE>, 2*LIST_LENGTH> fout, iout;
@@ -165,10 +229,529 @@ int test_nptfft(){
 			return -1;
 		}
 	}
+	if(max_rel_err(iout, NPtFFT<ConstFFTOP<> >()(l, r)) > 1e-6 ||
+		max_rel_err(iout, NPtFFT<ConstFFTOP<Gauss3> >()(l, r)) > 1e-6){
+		fprintf(stderr, "Error! NPtFFT with compile-time twiddles did not match\n");
+		return -1;
+	}
 	printf("NPtFFT test passed!\n");
 	return 0;
 }
 
+std::array<std::complex<DTYPE>, LIST_LENGTH> hw_synth_gauss_fft(std::array<std::complex<DTYPE>, LIST_LENGTH> input){
+#pragma HLS PIPELINE
+#pragma HLS ARRAY_PARTITION variable=input._M_instance COMPLETE
+	return fft_radix2<Gauss3>(input);
+}
+
+// A real number that counts the multiplies performed on it, standing in
+// for the DSPs of a fully unrolled FFT
+struct counted{
+	double v;
+	static long mults;
+	counted() : v(0){}
+	counted(double V) : v(V){}
+	counted operator*(counted const& R) const{
+		++mults;
+		return counted(v * R.v);
+	}
+	counted operator+(counted const& R) const{
+		return counted(v + R.v);
+	}
+	counted operator-(counted const& R) const{
+		return counted(v - R.v);
+	}
+	counted operator-() const{
+		return counted(-v);
+	}
+	counted& operator+=(counted const& R){
+		v += R.v;
+		return *this;
+	}
+	counted& operator-=(counted const& R){
+		v -= R.v;
+		return *this;
+	}
+};
+long counted::mults = 0;
+
+template <class MULT>
+long count_mults(std::array<std::complex<DTYPE>, LIST_LENGTH> const& IN, std::array<std::complex<DTYPE>, LIST_LENGTH> const& GOLD){
+	std::array<FFT_t<counted>, LIST_LENGTH> in, out;
+	for(int i = 0; i < LIST_LENGTH; ++i){
+		in[i] = {IN[i].real(), IN[i].imag()};
+	}
+	counted::mults = 0;
+	out = fft_radix2<MULT>(in);
+	long mults = counted::mults;
+	for(int i = 0; i < LIST_LENGTH; ++i){
+		if(std::abs(std::complex<double>(out[i].real().v, out[i].imag().v) - std::complex<double>(GOLD[i])) > 1e-2){
+			fprintf(stderr, "Error! Counted FFT Values at index %d did not match\n", i);
+			return -1;
+		}
+	}
+	return mults;
+}
+
+// Twiddle multiplies of the hof FFT: FFTOP always does 4 per butterfly;
+// ConstFFTOP drops them for trivial twiddles, and Gauss3 does 3 for the
+// others
+int test_twiddle_mults(){
+	std::array<std::complex<DTYPE>, LIST_LENGTH> gold, in, out;
+	for(int i = 0; i < LIST_LENGTH; i ++){
+		gold[i] = in[i] = {(DTYPE)(i % 7), (DTYPE)(i % 3) - 1};
+	}
+	gold = software::fft(gold);
+
+	out = hw_synth_gauss_fft(in);
+	if(max_rel_err(gold, out) > 1e-5){
+		fprintf(stderr, "Error! Gauss3 FFT Values did not match\n");
+		return -1;
+	}
+
+	long naive = 4L * (LIST_LENGTH / 2) * LOG_LIST_LENGTH;
+	long mult4 = count_mults<Mult4>(in, gold);
+	long gauss3 = count_mults<Gauss3>(in, gold);
+	if(mult4 < 0 || gauss3 < 0){
+		return -1;
+	}
+	printf("%d-point FFT multiplies: %ld with FFTOP, %ld with trivial twiddles removed, %ld with Gauss3\n",
+		LIST_LENGTH, naive, mult4, gauss3);
+	if(mult4 >= naive || gauss3 >= mult4){
+		fprintf(stderr, "Error! Compile-time twiddles did not remove multiplies\n");
+		return -1;
+	}
+	printf("FFT (compile-time twiddles) test passed!\n");
+	return 0;
+}
+
+// Checks the plan-based software FFT (the golden model) against a direct
+// O(N^2) DFT, with the same twiddle convention as FFTOP
+int test_software(){
+	std::array<std::complex<DTYPE>, LIST_LENGTH> in, out;
+	for(int i = 0; i < LIST_LENGTH; i ++){
+		in[i] = {(DTYPE)((i * 7) % 13 - 6), (DTYPE)((i * 3) % 11 - 5)};
+	}
+	out = software::fft(in);
+	for(int k = 0; k < LIST_LENGTH; ++k){
+		std::complex<double> dft = 0;
+		for(int n = 0; n < LIST_LENGTH; ++n){
+			double a = 2 * M_PI * ((n * k) % LIST_LENGTH) / LIST_LENGTH;
+			dft += std::complex<double>(in[n].real(), in[n].imag()) * std::complex<double>(std::cos(a), std::sin(a));
+		}
+		if(std::abs(std::complex<double>(out[k].real(), out[k].imag()) - dft) > 1e-3){
+			fprintf(stderr, "Error! Software FFT did not match the DFT at index %d\n", k);
+			return -1;
+		}
+	}
+	printf("FFT (software) test passed!\n");
+
+	std::vector<std::array<std::complex<DTYPE>, LIST_LENGTH> > frames(BATCH_FRAMES);
+	for(int f = 0; f < BATCH_FRAMES; ++f){
+		for(int i = 0; i < LIST_LENGTH; i ++){
+			frames[f][i] = {(DTYPE)(i + f), (DTYPE)(i - f)};
+		}
+	}
+	auto gold = frames;
+	// An empty batch leaves the frames alone
+	software::fft_batch(frames.data(), 0);
+	if(frames != gold){
+		fprintf(stderr, "Error! Empty FFT batch modified its frames\n");
+		return -1;
+	}
+	software::fft_batch(frames.data(), frames.size());
+	for(int f = 0; f < BATCH_FRAMES; ++f){
+		if(frames[f] != software::fft(gold[f])){
+			fprintf(stderr, "Error! Batched FFT frame %d did not match\n", f);
+			return -1;
+		}
+	}
+	printf("FFT (software batch) test passed!\n");
+	return 0;
+}
+
+// Checks that no cycle of the folded FFT accesses a bank twice: the load
+// and store write P consecutive points, and every stage reads 2*P
+// consecutive points and writes P points in each half of the frame
+template <std::size_t LEN, std::size_t P>
+int test_folded_banks(){
+	typedef _fftBanks<DTYPE, LEN, P> banks_t;
+	for(std::size_t c = 0; c < LEN/P; ++c){
+		std::bitset<2*P> ld;
+		for(std::size_t p = 0; p < P; ++p){
+			ld.set(banks_t::bank(c*P + p));
+		}
+		if(ld.count() != P){
+			fprintf(stderr, "Error! %lu-point folded FFT with P=%lu has a load bank conflict in cycle %lu\n", 
+				(unsigned long)LEN, (unsigned long)P, (unsigned long)c);
+			return -1;
+		}
+	}
+	for(std::size_t c = 0; c < LEN/(2*P); ++c){
+		std::bitset<2*P> rd, wr;
+		for(std::size_t p = 0; p < P; ++p){
+			std::size_t j = c*P + p;
+			rd.set(banks_t::bank(2*j)).set(banks_t::bank(2*j + 1));
+			wr.set(banks_t::bank(j)).set(banks_t::bank(j + LEN/2));
+		}
+		if(!rd.all() || !wr.all()){
+			fprintf(stderr, "Error! %lu-point folded FFT with P=%lu has a bank conflict in cycle %lu\n", 
+				(unsigned long)LEN, (unsigned long)P, (unsigned long)c);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+template <std::size_t P>
+int test_folded_p(std::array<std::complex<DTYPE>, LIST_LENGTH> const& IN, std::array<std::complex<DTYPE>, LIST_LENGTH> const& GOLD){
+	std::array<std::complex<DTYPE>, LIST_LENGTH> out = fft<folded<P> >(IN);
+	for(int i = 0; i < LIST_LENGTH; i ++){
+		if(std::abs(GOLD[i] - out[i]) > 1){
+			fprintf(stderr, "Error! Folded FFT (P=%lu) Values at index %d did not match\n", (unsigned long)P, i);
+			return -1;
+		}
+	}
+	return test_folded_banks<LIST_LENGTH, P>() || test_folded_banks<LARGE_LENGTH, P>();
+}
+
+std::array<std::complex<DTYPE>, LARGE_LENGTH> large_in, large_gold, large_out;
+
+// Host (C-sim) run time of a 64K-point folded FFT, with the cycle count
+// of the hardware schedule
+template <std::size_t P>
+int bench_folded(){
+	auto start = std::chrono::high_resolution_clock::now();
+	large_out = fft<folded<P> >(large_in);
+	auto stop = std::chrono::high_resolution_clock::now();
+	double err = 0, mag = 0;
+	for(int i = 0; i < LARGE_LENGTH; ++i){
+		err = std::max(err, (double)std::abs(large_gold[i] - large_out[i]));
+		mag = std::max(mag, (double)std::abs(large_gold[i]));
+	}
+	if(err > 1e-4 * mag){
+		fprintf(stderr, "Error! %d-point folded FFT (P=%lu) error %g exceeds %g\n", LARGE_LENGTH, (unsigned long)P, err, 1e-4 * mag);
+		return -1;
+	}
+	std::size_t cycles = 2*LARGE_LENGTH/P + LOG_LARGE_LENGTH*LARGE_LENGTH/(2*P);
+	printf("%d-point folded FFT, P=%lu: %lu cycles/frame, C-sim %.1f ms\n", LARGE_LENGTH, (unsigned long)P, 
+		(unsigned long)cycles, std::chrono::duration<double>(stop - start).count() * 1e3);
+	return 0;
+}
+
+int test_folded(){
+	std::array<std::complex<DTYPE>, LIST_LENGTH> in, gold, out;
+	for(int i = 0; i < LIST_LENGTH; i ++){
+		in[i] = {(DTYPE)((i * 7) % 13 - 6), (DTYPE)((i * 3) % 11 - 5)};
+	}
+	gold = fft(in);
+	if(test_folded_p<1>(in, gold) || test_folded_p<2>(in, gold) || test_folded_p<4>(in, gold) || test_folded_p<8>(in, gold)){
+		return -1;
+	}
+	out = hw_synth_folded_fft(in);
+	if(out != fft<folded<FOLDED_P> >(in) || fft<streaming>(in) != fft<folded<1> >(in)){
+		fprintf(stderr, "Error! Folded FFT designs did not match\n");
+		return -1;
+	}
+	// Folded FFTs running on several host threads at once must not share
+	// their frame buffers: each thread must get the single-threaded result
+	std::vector<std::array<std::complex<DTYPE>, LIST_LENGTH> > xs(4), ys(4);
+	for(int t = 0; t < 4; ++t){
+		for(int i = 0; i < LIST_LENGTH; ++i){
+			xs[t][i] = {(DTYPE)((i * (t + 2)) % 17 - 8), (DTYPE)t};
+		}
+		ys[t] = fft<folded<2> >(xs[t]);
+	}
+	std::vector<int> bad(4, 0);
+	std::vector<std::thread> threads;
+	for(int t = 0; t < 4; ++t){
+		threads.emplace_back([&xs, &ys, &bad, t](){
+				for(int r = 0; r < 2000; ++r){
+					bad[t] |= (fft<folded<2> >(xs[t]) != ys[t]);
+				}
+			});
+	}
+	for(std::thread& t : threads){
+		t.join();
+	}
+	if(bad != std::vector<int>(4, 0)){
+		fprintf(stderr, "Error! Concurrent folded FFTs did not match\n");
+		return -1;
+	}
+	printf("FFT (folded) test passed!\n");
+
+	for(int i = 0; i < LARGE_LENGTH; ++i){
+		large_in[i] = {(DTYPE)((i * 7) % 13 - 6), (DTYPE)((i * 3) % 11 - 5)};
+	}
+	large_gold = software::fft(large_in);
+	if(bench_folded<1>() || bench_folded<2>() || bench_folded<4>() || bench_folded<8>()){
+		return -1;
+	}
+	printf("FFT (folded, %d-point) test passed!\n", LARGE_LENGTH);
+	return 0;
+}
+
+std::array<std::complex<DTYPE>, HUGE_LENGTH> huge_in, huge_gold, huge_out;
+
+int test_fourstep(){
+	std::array<std::complex<DTYPE>, LIST_LENGTH> in, gold, out;
+	for(int i = 0; i < LIST_LENGTH; i ++){
+		in[i] = {(DTYPE)((i * 7) % 13 - 6), (DTYPE)((i * 3) % 11 - 5)};
+	}
+	gold = software::fft(in);
+	out = in;
+	software::fft_fourstep<LIST_ROOT, LIST_ROOT>(out);
+	if(max_rel_err(gold, out) > 1e-5){
+		fprintf(stderr, "Error! %d-point four-step FFT did not match\n", LIST_LENGTH);
+		return -1;
+	}
+
+	stream<std::complex<DTYPE> > sin, sout;
+	for(int i = 0; i < LIST_LENGTH; i ++){
+		sin << in[i];
+	}
+	hw_synth_fourstep(sin, sout);
+	for(int i = 0; i < LIST_LENGTH; i ++){
+		sout >> out[i];
+	}
+	if(max_rel_err(gold, out) > 1e-5){
+		fprintf(stderr, "Error! %d-point streaming four-step FFT did not match\n", LIST_LENGTH);
+		return -1;
+	}
+	printf("FFT (four-step) test passed!\n");
+
+	// large_in and large_gold are set by test_folded
+	large_out = large_in;
+	software::fft_fourstep<LARGE_ROOT, LARGE_ROOT>(large_out);
+	if(max_rel_err(large_gold, large_out) > 1e-5){
+		fprintf(stderr, "Error! %d-point four-step FFT did not match\n", LARGE_LENGTH);
+		return -1;
+	}
+
+	// A kernel thread streams the frame through the four-step engine
+	stream<std::complex<DTYPE>, STREAM_DEPTH> lin, lout;
+	std::thread k(fft_fourstep<LARGE_ROOT, LARGE_ROOT, DTYPE, STREAM_DEPTH>, std::ref(lin), std::ref(lout));
+	for(int i = 0; i < LARGE_LENGTH; i ++){
+		lin << large_in[i];
+	}
+	for(int i = 0; i < LARGE_LENGTH; i ++){
+		lout >> large_out[i];
+	}
+	k.join();
+	if(max_rel_err(large_gold, large_out) > 1e-5){
+		fprintf(stderr, "Error! %d-point streaming four-step FFT did not match\n", LARGE_LENGTH);
+		return -1;
+	}
+	printf("FFT (four-step, %d-point) test passed!\n", LARGE_LENGTH);
+	return 0;
+}
+
+// Checks fft2d against software::fft over the rows, then the columns
+template <std::size_t R, std::size_t C>
+int test_fft2d_rc(){
+	tile_t<DTYPE, R, C> in, gold, out;
+	for(std::size_t r = 0; r < R; ++r){
+		for(std::size_t c = 0; c < C; ++c){
+			in[r][c] = {(DTYPE)((r * 7 + c * 3) % 13 - 6), (DTYPE)((r * 5 + c) % 11 - 5)};
+		}
+		gold[r] = software::fft(in[r]);
+	}
+	for(std::size_t c = 0; c < C; ++c){
+		std::array<std::complex<DTYPE>, R> col;
+		for(std::size_t r = 0; r < R; ++r){
+			col[r] = gold[r][c];
+		}
+		col = software::fft(col);
+		for(std::size_t r = 0; r < R; ++r){
+			gold[r][c] = col[r];
+		}
+	}
+	out = fft2d(in);
+	for(std::size_t r = 0; r < R; ++r){
+		if(max_rel_err(gold[r], out[r]) > 1e-3){
+			fprintf(stderr, "Error! %dx%d FFT2D row %d did not match\n", (int)R, (int)C, (int)r);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+int test_fft2d(){
+	if(test_fft2d_rc<LIST_ROOT, LIST_ROOT>() || test_fft2d_rc<TILE_ROWS, TILE_COLS>() || 
+		test_fft2d_rc<TILE_COLS, TILE_ROWS>() || test_fft2d_rc<LIST_LENGTH, LIST_LENGTH>()){
+		return -1;
+	}
+	tile_t<DTYPE, TILE_ROWS, TILE_COLS> in;
+	for(std::size_t r = 0; r < TILE_ROWS; ++r){
+		for(std::size_t c = 0; c < TILE_COLS; ++c){
+			in[r][c] = {(DTYPE)r, (DTYPE)c};
+		}
+	}
+	if(hw_synth_fft2d(in) != fft2d(in)){
+		fprintf(stderr, "Error! FFT2D design did not match\n");
+		return -1;
+	}
+	printf("FFT2D test passed!\n");
+	return 0;
+}
+
+// Direct O(N^2) DFT in double precision, with the twiddle convention of
+// FFTOP
+template <std::size_t LEN>
+std::array<std::complex<DTYPE>, LEN> dft(std::array<std::complex<DTYPE>, LEN> const& IN){
+	std::array<std::complex<DTYPE>, LEN> out;
+	for(std::size_t k = 0; k < LEN; ++k){
+		std::complex<double> acc = 0;
+		for(std::size_t n = 0; n < LEN; ++n){
+			double a = 2 * M_PI * ((n * k) % LEN) / LEN;
+			acc += std::complex<double>(IN[n].real(), IN[n].imag()) * std::complex<double>(std::cos(a), std::sin(a));
+		}
+		out[k] = {(DTYPE)acc.real(), (DTYPE)acc.imag()};
+	}
+	return out;
+}
+
+// Checks fft (which picks the engine), fft_mixed and fft_bluestein
+// against the DFT for a LEN that is not a power of two
+template <std::size_t LEN>
+int test_mixed_len(){
+	std::array<std::complex<DTYPE>, LEN> in;
+	for(std::size_t i = 0; i < LEN; i ++){
+		in[i] = {(DTYPE)((i * 7) % 13 - 6), (DTYPE)((i * 3) % 11 - 5)};
+	}
+	std::array<std::complex<DTYPE>, LEN> gold = dft(in);
+	if(max_rel_err(gold, fft(in)) > 1e-5 || max_rel_err(gold, fft_mixed(in)) > 1e-5 || 
+		max_rel_err(gold, fft_bluestein(in)) > 1e-5){
+		fprintf(stderr, "Error! %d-point FFT did not match the DFT\n", (int)LEN);
+		return -1;
+	}
+	return 0;
+}
+
+std::array<std::complex<DTYPE>, MIXED_LENGTH> hw_synth_mixed_fft(std::array<std::complex<DTYPE>, MIXED_LENGTH> input){
+	return fft(input);
+}
+
+int test_mixed(){
+	// Mixed radix, then prime lengths (Bluestein)
+	if(test_mixed_len<12>() || test_mixed_len<15>() || test_mixed_len<60>() || test_mixed_len<MIXED_LENGTH>() ||
+		test_mixed_len<7>() || test_mixed_len<17>() || test_mixed_len<97>() || test_mixed_len<98>()){
+		return -1;
+	}
+	std::array<std::complex<DTYPE>, LIST_LENGTH> in;
+	for(int i = 0; i < LIST_LENGTH; i ++){
+		in[i] = {(DTYPE)((i * 7) % 13 - 6), (DTYPE)((i * 3) % 11 - 5)};
+	}
+	if(max_rel_err(fft_radix2(in), fft_mixed(in)) > 1e-6){
+		fprintf(stderr, "Error! Mixed-radix FFT did not match the radix-2 FFT\n");
+		return -1;
+	}
+	printf("FFT (mixed radix, Bluestein) test passed!\n");
+
+	// A 1536-point transform, against zero-padding to 2048 points
+	std::array<std::complex<DTYPE>, MIXED_LENGTH> min{}, mout;
+	std::array<std::complex<DTYPE>, PADDED_LENGTH> pin{}, pout;
+	for(int i = 0; i < MIXED_LENGTH; ++i){
+		min[i] = pin[i] = {(DTYPE)(i % 17), (DTYPE)(i % 5)};
+	}
+	auto start = std::chrono::high_resolution_clock::now();
+	for(int i = 0; i < BENCH_ITERS; ++i){
+		mout = hw_synth_mixed_fft(min);
+	}
+	auto mid = std::chrono::high_resolution_clock::now();
+	for(int i = 0; i < BENCH_ITERS; ++i){
+		pout = fft(pin);
+	}
+	auto stop = std::chrono::high_resolution_clock::now();
+	printf("%d-point FFT C-sim time: mixed radix %.1f us/call, zero-padded to %d points %.1f us/call\n", MIXED_LENGTH, 
+		std::chrono::duration<double>(mid - start).count() * 1e6 / BENCH_ITERS, PADDED_LENGTH, 
+		std::chrono::duration<double>(stop - mid).count() * 1e6 / BENCH_ITERS);
+	// Zero-padding does not change the sum of the input (bin 0)
+	if(std::abs(mout[0] - pout[0]) > 1e-3 * std::abs(pout[0])){
+		fprintf(stderr, "Error! %d-point and zero-padded FFTs have different DC bins\n", MIXED_LENGTH);
+		return -1;
+	}
+	return 0;
+}
+
+// Host (C-sim) run time of a 1M-point FFT: one fft_plan over the whole
+// frame, and the four-step engine with the hof and plan-based kernels
+int bench_fourstep(){
+	for(int i = 0; i < HUGE_LENGTH; ++i){
+		huge_in[i] = {(DTYPE)(i % 17), (DTYPE)(i % 5)};
+	}
+	// Build (and cache) the plans before timing
+	huge_gold = huge_in;
+	software::fft_inplace(huge_gold);
+	software::fft_fourstep<HUGE_ROOT, HUGE_ROOT, software::FFT>(huge_out);
+	software::fft_fourstep<HUGE_ROOT, HUGE_ROOT>(huge_out);
+	auto start = std::chrono::high_resolution_clock::now();
+	huge_gold = huge_in;
+	software::fft_inplace(huge_gold);
+	auto mid = std::chrono::high_resolution_clock::now();
+	huge_out = huge_in;
+	software::fft_fourstep<HUGE_ROOT, HUGE_ROOT, software::FFT>(huge_out);
+	auto stop = std::chrono::high_resolution_clock::now();
+	double sw = std::chrono::duration<double>(mid - start).count();
+	double fs = std::chrono::duration<double>(stop - mid).count();
+	if(max_rel_err(huge_gold, huge_out) > 1e-5){
+		fprintf(stderr, "Error! %d-point four-step FFT (software kernel) did not match\n", HUGE_LENGTH);
+		return -1;
+	}
+
+	start = std::chrono::high_resolution_clock::now();
+	huge_out = huge_in;
+	software::fft_fourstep<HUGE_ROOT, HUGE_ROOT>(huge_out);
+	stop = std::chrono::high_resolution_clock::now();
+	double fh = std::chrono::duration<double>(stop - start).count();
+	if(max_rel_err(huge_gold, huge_out) > 1e-5){
+		fprintf(stderr, "Error! %d-point four-step FFT (hof kernel) did not match\n", HUGE_LENGTH);
+		return -1;
+	}
+	printf("%d-point FFT C-sim time: software %.1f ms, four-step (software kernel) %.1f ms, four-step (hof kernel) %.1f ms\n", 
+		HUGE_LENGTH, sw * 1e3, fs * 1e3, fh * 1e3);
+	return 0;
+}
+
+std::array<std::complex<DTYPE>, BENCH_LENGTH> bench_in, bench_gold, bench_out;
+std::vector<std::array<std::complex<DTYPE>, BENCH_LENGTH> > bench_frames(BATCH_FRAMES);
+
+// Host (C-sim) run time of the hof FFT and the software (golden model)
+// FFT, one frame at a time and batched
+int bench_fft(){
+	for(int i = 0; i < BENCH_LENGTH; ++i){
+		bench_in[i] = {(DTYPE)(i % 17), (DTYPE)(i % 5)};
+	}
+	for(int f = 0; f < BATCH_FRAMES; ++f){
+		bench_frames[f] = bench_in;
+	}
+	auto start = std::chrono::high_resolution_clock::now();
+	for(int i = 0; i < BENCH_ITERS; ++i){
+		bench_out = fft(bench_in);
+	}
+	auto mid = std::chrono::high_resolution_clock::now();
+	for(int i = 0; i < BENCH_ITERS; ++i){
+		bench_gold = software::fft(bench_in);
+	}
+	auto bstart = std::chrono::high_resolution_clock::now();
+	software::fft_batch(bench_frames.data(), bench_frames.size());
+	auto stop = std::chrono::high_resolution_clock::now();
+
+	for(int i = 0; i < BENCH_LENGTH; ++i){
+		if(std::abs(bench_gold[i] - bench_out[i]) > 1 || bench_frames[BATCH_FRAMES - 1][i] != bench_gold[i]){
+			fprintf(stderr, "Error! %d-point FFT Values at index %d did not match\n", BENCH_LENGTH, i);
+			return -1;
+		}
+	}
+	double flops = 5.0 * BENCH_LENGTH * LOG_BENCH_LENGTH;
+	double hof = std::chrono::duration<double>(mid - start).count() / BENCH_ITERS;
+	double sw = std::chrono::duration<double>(bstart - mid).count() / BENCH_ITERS;
+	double batch = std::chrono::duration<double>(stop - bstart).count() / BATCH_FRAMES;
+	printf("%d-point FFT C-sim time: hof %.1f us/call, software %.1f us/call (%.0f MFLOP/s), software batch %.1f us/frame (%.0f MFLOP/s)\n", 
+		BENCH_LENGTH, hof * 1e6, sw * 1e6, flops / sw / 1e6, batch * 1e6, flops / batch / 1e6);
+	return 0;
+}
+
 int main(){
 	int err;
 	if((err = test_nptfft())){
@@ -177,6 +760,30 @@ int main(){
 	if((err = test_fft())){
 		return err;
 	}
+	if((err = test_twiddle_mults())){
+		return err;
+	}
+	if((err = test_software())){
+		return err;
+	}
+	if((err = test_folded())){
+		return err;
+	}
+	if((err = test_fourstep())){
+		return err;
+	}
+	if((err = test_fft2d())){
+		return err;
+	}
+	if((err = test_mixed())){
+		return err;
+	}
+	if((err = bench_fft())){
+		return err;
+	}
+	if((err = bench_fourstep())){
+		return err;
+	}
 	return 0;	
 }
 
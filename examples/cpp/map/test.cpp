@@ -80,7 +80,7 @@ constexpr std::size_t bitreverse(std::size_t v){
 
 class Breverse{
 public:
-	unsigned int operator()(unsigned int const& v){
+	CONSTEXPR17 unsigned int operator()(unsigned int const& v){
 #pragma HLS INLINE
 		return bitreverse<LOG_LIST_LENGTH>(v);
 	}
@@ -111,6 +111,12 @@ std::array<float, LIST_LENGTH> hw_synth_multby(std::array<float, LIST_LENGTH> IN
 	return map<MultBy<35>>(IN);
 }
 
+void hw_synth_multby_inplace(std::array<float, LIST_LENGTH>& IO){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IO._M_instance
+#pragma HLS PIPELINE
+	map_inplace<MultBy<35>>(IO);
+}
+
 struct Mult{
 	float operator()(float L, float R){
 #pragma HLS INLINE
@@ -145,8 +151,14 @@ int test_multby(){
 			return -1;
 		}
 	}
-	
 	printf("Multby Test Passed!\n");
+
+	hw_synth_multby_inplace(in);
+	if(in != output){
+		fprintf(stderr, "Error! Multby (map_inplace) did not match map\n");
+		return -1;
+	}
+	printf("Multby (map_inplace) Test Passed!\n");
 	return 0;
 }
 
@@ -196,6 +208,38 @@ int test_breverse(){
 	return 0;
 }
 
+// Under C++17 constant tables, such as a bit-reverse table, can be built
+// with map, zipWith and the list operations entirely at compile time
+struct Xor{
+	CONSTEXPR17 std::size_t operator()(std::size_t L, std::size_t R){
+		return L ^ R;
+	}
+};
+
+struct Half{
+	CONSTEXPR17 std::size_t operator()(std::size_t V){
+		return V >> 1;
+	}
+};
+
+int test_constexpr(){
+#if __cplusplus >= 201703L
+	constexpr std::array<unsigned int, LIST_LENGTH> table = map<Breverse>(range<LIST_LENGTH>());
+	constexpr std::array<std::size_t, LIST_LENGTH> gray = zipWith<Xor>(range<LIST_LENGTH>(), map<Half>(range<LIST_LENGTH>()));
+	static_assert(table[1] == LIST_LENGTH/2, "Constexpr bit-reverse table is incorrect");
+	static_assert(reverse(table)[0] == LIST_LENGTH - 1, "Constexpr bit-reverse table is incorrect");
+	static_assert(gray[5] == 7, "Constexpr Gray code table is incorrect");
+	for(unsigned int i = 0; i < LIST_LENGTH; ++i){
+		if(table[i] != breverse(i) || gray[i] != (i ^ (i >> 1))){
+			fprintf(stderr, "Error! Constexpr table is incorrect at index %d\n", i);
+			return -1;
+		}
+	}
+	printf("Constexpr Map Test Passed!\n");
+#endif
+	return 0;
+}
+
 int main(){
 	int err;
 	if((err = test_truncate())){
@@ -210,6 +254,9 @@ int main(){
 	if((err = test_pair_mult())){
 		return err;
 	}
+	if((err = test_constexpr())){
+		return err;
+	}
 	printf("Map Tests passed\n");
 	return 0;	
 }
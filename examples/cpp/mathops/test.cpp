@@ -0,0 +1,290 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#include <array>
+#include <utility>
+#include <cmath>
+#include "mathops.hpp"
+#include "map.hpp"
+#include "zip.hpp"
+#include "testops.hpp"
+
+#define LIST_LENGTH 64
+#define SWEEP 4096
+
+// A number that counts the operators performed on it
+struct counted{
+	double v;
+	static long mults, adds, shifts;
+	counted() : v(0){}
+	counted(double V) : v(V){}
+	explicit operator double() const{
+		return v;
+	}
+	// Truncation to an integer, as in range reduction
+	explicit operator long() const{
+		return (long)v;
+	}
+	counted operator*(counted const& R) const{
+		++mults;
+		return counted(v * R.v);
+	}
+	counted operator+(counted const& R) const{
+		++adds;
+		return counted(v + R.v);
+	}
+	counted operator-(counted const& R) const{
+		++adds;
+		return counted(v - R.v);
+	}
+	bool operator<(counted const& R) const{
+		return v < R.v;
+	}
+};
+long counted::mults = 0;
+long counted::adds = 0;
+long counted::shifts = 0;
+
+// Scaling by a power of two is a shift (or an exponent add). Range
+// reduction of counted values uses the generic (fixed-point) forms, so
+// the shifts of its leading-zero search are counted too.
+counted _scalb(counted const& X, int E){
+	++counted::shifts;
+	return counted(std::ldexp(X.v, E));
+}
+
+std::array<float, LIST_LENGTH> hw_synth_cordic_sincos(std::array<float, LIST_LENGTH> const& IN){
+	return map<Cordic<Sin, 16>>(IN);
+}
+
+std::array<float, LIST_LENGTH> hw_synth_cordic_atan2(std::array<float, LIST_LENGTH> const& Y, std::array<float, LIST_LENGTH> const& X){
+	return zipWith<Cordic<Atan2, 16>>(Y, X);
+}
+
+std::array<float, LIST_LENGTH> hw_synth_polyexp(std::array<float, LIST_LENGTH> const& IN){
+	return map<PolyExp<5>>(IN);
+}
+
+std::array<float, LIST_LENGTH> hw_synth_rsqrt(std::array<float, LIST_LENGTH> const& IN){
+	return map<RSqrt<2>>(IN);
+}
+
+struct StdSin{
+	template <typename T>
+	T operator()(T X){
+		return std::sin(X);
+	}
+};
+
+struct StdAtan2{
+	template <typename T>
+	T operator()(T Y, T X){
+		return std::atan2(Y, X);
+	}
+};
+
+struct StdExp{
+	template <typename T>
+	T operator()(T X){
+		return std::exp(X);
+	}
+};
+
+struct StdRSqrt{
+	template <typename T>
+	T operator()(T X){
+		return T(1) / std::sqrt(X);
+	}
+};
+
+// Arguments of the sweeps
+double angle(int I){
+	return -2 * M_PI + 4 * M_PI * I / SWEEP;
+}
+
+double expArg(int I){
+	return -20 + 40.0 * I / SWEEP;
+}
+
+double rsqrtArg(int I){
+	return std::ldexp(1.0 + (I % 97) / 97.0, I % 41 - 20);
+}
+
+// Runs FTOR (on one argument, or on two for ARITY 2) over the sweep with
+// counted values, and returns the largest error against GOLD, the
+// <cmath> function in double precision (relative when REL)
+template <class FTOR, class GOLD, std::size_t ARITY>
+struct _sweep;
+
+template <class FTOR, class GOLD>
+struct _sweep<FTOR, GOLD, 1>{
+	template <class ARG>
+	static double err(ARG A, bool REL){
+		double e = 0;
+		for(int i = 0; i < SWEEP; ++i){
+			double g = GOLD()(A(i));
+			double o = (double)FTOR()(counted(A(i)));
+			e = std::max(e, std::abs(o - g) / (REL ? std::abs(g) : 1));
+		}
+		return e;
+	}
+
+};
+
+template <class FTOR, class GOLD>
+struct _sweep<FTOR, GOLD, 2>{
+	template <class ARG>
+	static double err(ARG A, bool REL){
+		double e = 0;
+		for(int i = 0; i < SWEEP; ++i){
+			double g = GOLD()(std::sin(A(i)) * 3, std::cos(A(i)) * 3);
+			double o = (double)FTOR()(counted(std::sin(A(i)) * 3), counted(std::cos(A(i)) * 3));
+			e = std::max(e, std::abs(o - g) / (REL ? std::abs(g) : 1));
+		}
+		return e;
+	}
+
+};
+
+template <class FTOR, class GOLD, std::size_t ARITY = 1, class ARG>
+int report(const char * NAME, ARG A, bool REL, double TOL){
+	counted::mults = counted::adds = counted::shifts = 0;
+	double e = _sweep<FTOR, GOLD, ARITY>::err(A, REL);
+	double ops[3] = {(double)counted::adds / SWEEP, (double)counted::mults / SWEEP, (double)counted::shifts / SWEEP};
+	printf("%-18s %s error %9.2e %6.1f add %6.1f mult %6.1f shift\n", 
+		NAME, REL ? "rel" : "abs", e, ops[0], ops[1], ops[2]);
+	if(e > TOL){
+		fprintf(stderr, "Error! %s error %g exceeds %g\n", NAME, e, TOL);
+		return -1;
+	}
+	return 0;
+}
+
+int test_designs(){
+	std::array<float, LIST_LENGTH> a, y, x, e, r;
+	for(int i = 0; i < LIST_LENGTH; ++i){
+		a[i] = angle(i * SWEEP / LIST_LENGTH);
+		y[i] = std::sin(a[i]);
+		x[i] = std::cos(a[i]);
+		e[i] = expArg(i * SWEEP / LIST_LENGTH) / 4;
+		r[i] = rsqrtArg(i);
+	}
+	std::array<float, LIST_LENGTH> s = hw_synth_cordic_sincos(a), t = hw_synth_cordic_atan2(y, x);
+	std::array<float, LIST_LENGTH> p = hw_synth_polyexp(e), q = hw_synth_rsqrt(r);
+	for(int i = 0; i < LIST_LENGTH; ++i){
+		if(std::abs(s[i] - std::sin(a[i])) > 1e-4 || std::abs(t[i] - std::atan2(y[i], x[i])) > 1e-4 ||
+			std::abs(p[i] / std::exp(e[i]) - 1) > 1e-4 || std::abs(q[i] * std::sqrt(r[i]) - 1) > 1e-3){
+			fprintf(stderr, "Error! Math functor designs did not match <cmath> at index %d\n", i);
+			return -1;
+		}
+	}
+	std::pair<float, float> cs = Cordic<SinCos>()(1.0f);
+	if(std::abs(cs.first - std::cos(1.0f)) > 1e-5 || std::abs(Cordic<Cos>()(-2.5f) - std::cos(-2.5f)) > 1e-5 ||
+		std::abs(Cordic<Hypot>()(3.0f, -4.0f) - 5) > 1e-4 || std::abs(Sqrt<>()(2.0f) - std::sqrt(2.0f)) > 1e-6){
+		fprintf(stderr, "Error! Cos, SinCos, Hypot or Sqrt did not match <cmath>\n");
+		return -1;
+	}
+	// Runtime FFT twiddles (cos, sin) of -2*pi*k/LIST_LENGTH, as in CalcAngle
+	std::array<float, LIST_LENGTH> w;
+	for(int k = 0; k < LIST_LENGTH; ++k){
+		w[k] = -2 * M_PI * k / LIST_LENGTH;
+	}
+	std::array<std::pair<float, float>, LIST_LENGTH> tw = map<Cordic<SinCos, 20>>(w);
+	for(int k = 0; k < LIST_LENGTH; ++k){
+		if(std::abs(tw[k].first - std::cos(w[k])) > 1e-5 || std::abs(tw[k].second - std::sin(w[k])) > 1e-5){
+			fprintf(stderr, "Error! Cordic twiddle %d did not match <cmath>\n", k);
+			return -1;
+		}
+	}
+	// _scalb adds to the exponent of floats and doubles (saturating to
+	// infinity, and flushing to zero), and shifts fixed-point values
+	int fe;
+	if(_scalb(1.5f, 10) != 1536.0f || _scalb(-3.0, -4) != -0.1875 || _scalb(1e30f, 100) != INFINITY ||
+		_scalb(-1e-30f, -100) != 0.0f || _scalb(0.0f, 5) != 0.0f || _scalb(96, -3) != 12 || _scalb(3, 4) != 48 ||
+		_frexp(12.0f, fe) != 0.75f || fe != 4 || _frexp(0.1, fe) != std::frexp(0.1, &fe) ||
+		(double)_frexp(counted(0.1), fe) != std::frexp(0.1, &fe) ||
+		(double)_frexp(counted(std::ldexp(0.75, 100)), fe) != 0.75 || fe != 100){
+		fprintf(stderr, "Error! _scalb or _frexp did not match <cmath>\n");
+		return -1;
+	}
+	printf("Math functor designs Test Passed!\n");
+	return 0;
+}
+
+// The width and integer width of an ap_fixed<128, 100>
+struct wide_fixed{
+	static const int width = 128;
+	static const int iwidth = 100;
+};
+
+struct deep_fixed{
+	static const int width = 16;
+	static const int iwidth = -40;
+};
+
+// The fixed-point _frexp search covers every exponent of the type
+static_assert(_frexpBound<wide_fixed>::value == 101, "_frexpBound is incorrect for an ap_fixed<128, 100>");
+static_assert(_frexpBound<deep_fixed>::value == 57, "_frexpBound is incorrect for an ap_fixed<16, -40>");
+static_assert(_frexpBound<counted>::value == 64, "_frexpBound is incorrect for a 64-bit type");
+
+int bench(){
+	printf("Error against <cmath>, and operators per call (with range reduction):\n");
+	if(report<Cordic<Sin, 8>, StdSin>("Cordic<Sin, 8>", angle, false, 1e-2) ||
+		report<Cordic<Sin, 16>, StdSin>("Cordic<Sin, 16>", angle, false, 1e-4) ||
+		report<Cordic<Sin, 24>, StdSin>("Cordic<Sin, 24>", angle, false, 1e-6) ||
+		report<Cordic<Atan2, 8>, StdAtan2, 2>("Cordic<Atan2, 8>", angle, false, 1e-2) ||
+		report<Cordic<Atan2, 16>, StdAtan2, 2>("Cordic<Atan2, 16>", angle, false, 1e-4) ||
+		report<Cordic<Atan2, 24>, StdAtan2, 2>("Cordic<Atan2, 24>", angle, false, 1e-6) ||
+		report<PolyExp<3>, StdExp>("PolyExp<3>", expArg, true, 1e-3) ||
+		report<PolyExp<5>, StdExp>("PolyExp<5>", expArg, true, 1e-5) ||
+		report<PolyExp<7>, StdExp>("PolyExp<7>", expArg, true, 1e-8) ||
+		report<RSqrt<1>, StdRSqrt>("RSqrt<1>", rsqrtArg, true, 2e-2) ||
+		report<RSqrt<2>, StdRSqrt>("RSqrt<2>", rsqrtArg, true, 5e-4) ||
+		report<RSqrt<3>, StdRSqrt>("RSqrt<3>", rsqrtArg, true, 1e-7)){
+		return -1;
+	}
+	return 0;
+}
+
+int main(){
+	int err;
+	if((err = test_designs())){
+		return err;
+	}
+	if((err = bench())){
+		return err;
+	}
+	printf("Mathops Tests passed\n");
+	return 0;	
+}
@@ -0,0 +1,291 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#include <array>
+#include <chrono>
+#include "matrix.hpp"
+#include "testops.hpp"
+#ifdef BIT_ACCURATE
+#include "ap_int.h"
+#endif
+
+#define DIM_M 64
+#define DIM_K 32
+#define DIM_N 48
+#define TILE_M 8
+#define TILE_K 8
+#define TILE_N 8
+#define BENCH_ITERS 20
+
+template <typename T, std::size_t R, std::size_t C>
+using mat_t = std::array<std::array<T, C>, R>;
+
+// A number that counts the multiplies and adds performed on it
+struct counted{
+	int v;
+	static long mults, adds;
+	counted() : v(0){}
+	counted(int V) : v(V){}
+	counted operator*(counted const& R) const{
+		++mults;
+		return counted(v * R.v);
+	}
+	counted operator+(counted const& R) const{
+		++adds;
+		return counted(v + R.v);
+	}
+};
+long counted::mults = 0;
+long counted::adds = 0;
+
+template <typename T, std::size_t M, std::size_t K, std::size_t N>
+mat_t<T, M, N> for_matmul(mat_t<T, M, K> const& A, mat_t<T, K, N> const& B){
+	mat_t<T, M, N> c;
+	for(std::size_t i = 0; i < M; ++i){
+		for(std::size_t j = 0; j < N; ++j){
+			T acc = A[i][0] * B[0][j];
+			for(std::size_t k = 1; k < K; ++k){
+				acc = acc + A[i][k] * B[k][j];
+			}
+			c[i][j] = acc;
+		}
+	}
+	return c;
+}
+
+template <typename T, std::size_t M, std::size_t N>
+std::array<T, M> for_gemv(mat_t<T, M, N> const& A, std::array<T, N> const& X){
+	std::array<T, M> y;
+	for(std::size_t i = 0; i < M; ++i){
+		T acc = A[i][0] * X[0];
+		for(std::size_t j = 1; j < N; ++j){
+			acc = acc + A[i][j] * X[j];
+		}
+		y[i] = acc;
+	}
+	return y;
+}
+
+template <typename T>
+mat_t<T, DIM_M, DIM_N> hw_synth_matmul_tree(mat_t<T, DIM_M, DIM_K> const& A, mat_t<T, DIM_K, DIM_N> const& B){
+	return matmul<TILE_M, TILE_K, TILE_N, DotTree>(A, B);
+}
+
+template <typename T>
+mat_t<T, DIM_M, DIM_N> hw_synth_matmul_systolic(mat_t<T, DIM_M, DIM_K> const& A, mat_t<T, DIM_K, DIM_N> const& B){
+	return matmul<TILE_M, TILE_K, TILE_N, Systolic>(A, B);
+}
+
+template <typename T>
+mat_t<T, DIM_M, DIM_N> hw_synth_for_matmul(mat_t<T, DIM_M, DIM_K> const& A, mat_t<T, DIM_K, DIM_N> const& B){
+	return for_matmul(A, B);
+}
+
+template <typename T>
+std::array<T, DIM_M> hw_synth_gemv_tree(mat_t<T, DIM_M, DIM_K> const& A, std::array<T, DIM_K> const& X){
+	return gemv<TILE_M, TILE_K, DotTree>(A, X);
+}
+
+template <typename T>
+std::array<T, DIM_M> hw_synth_gemv_systolic(mat_t<T, DIM_M, DIM_K> const& A, std::array<T, DIM_K> const& X){
+	return gemv<TILE_M, TILE_K, Systolic>(A, X);
+}
+
+template <typename T>
+std::array<T, DIM_M> hw_synth_for_gemv(mat_t<T, DIM_M, DIM_K> const& A, std::array<T, DIM_K> const& X){
+	return for_gemv(A, X);
+}
+
+template <std::size_t R, std::size_t C>
+mat_t<counted, R, C> genmat(){
+	mat_t<counted, R, C> m;
+	for(std::size_t i = 0; i < R; ++i){
+		std::array<int, C> row = genarr<-100, 100, C>();
+		for(std::size_t j = 0; j < C; ++j){
+			m[i][j] = row[j];
+		}
+	}
+	return m;
+}
+
+template <class FN>
+double bench(FN F){
+	auto start = std::chrono::high_resolution_clock::now();
+	for(int i = 0; i < BENCH_ITERS; ++i){
+		F();
+	}
+	auto stop = std::chrono::high_resolution_clock::now();
+	return std::chrono::duration<double>(stop - start).count() / BENCH_ITERS;
+}
+
+void report(const char * NAME, double SECS, long MACS){
+	printf("%-18s %10.1f us/call %10.1f MMAC/s %8ld mults/call %8ld adds/call\n", NAME, SECS * 1e6, 
+		MACS / SECS / 1e6, counted::mults / BENCH_ITERS, counted::adds / BENCH_ITERS);
+	counted::mults = counted::adds = 0;
+}
+
+int test_matmul(){
+	mat_t<counted, DIM_M, DIM_K> a = genmat<DIM_M, DIM_K>();
+	mat_t<counted, DIM_K, DIM_N> b = genmat<DIM_K, DIM_N>();
+	mat_t<counted, DIM_M, DIM_N> gold = hw_synth_for_matmul(a, b);
+	mat_t<counted, DIM_M, DIM_N> tree = hw_synth_matmul_tree(a, b);
+	mat_t<counted, DIM_M, DIM_N> sys = hw_synth_matmul_systolic(a, b);
+	for(std::size_t i = 0; i < DIM_M; ++i){
+		for(std::size_t j = 0; j < DIM_N; ++j){
+			if(tree[i][j].v != gold[i][j].v || sys[i][j].v != gold[i][j].v){
+				fprintf(stderr, "Error! Matmul returned the incorrect value at (%d, %d). Gold: %d, DotTree: %d, Systolic: %d\n", 
+					(int)i, (int)j, gold[i][j].v, tree[i][j].v, sys[i][j].v);
+				return -1;
+			}
+		}
+	}
+	printf("Matmul (DotTree, Systolic) Test Passed!\n");
+
+	const long macs = (long)DIM_M * DIM_K * DIM_N;
+	counted::mults = counted::adds = 0;
+	printf("Matmul %dx%dx%d, %dx%dx%d core:\n", DIM_M, DIM_K, DIM_N, TILE_M, TILE_K, TILE_N);
+	report("for", bench([&](){ gold = hw_synth_for_matmul(a, b); }), macs);
+	report("DotTree", bench([&](){ tree = hw_synth_matmul_tree(a, b); }), macs);
+	report("Systolic", bench([&](){ sys = hw_synth_matmul_systolic(a, b); }), macs);
+	printf("Operators per core: DotTree %d mult/%d add, Systolic %d mult/%d add\n",
+		TILE_M * TILE_N * TILE_K, TILE_M * TILE_N * TILE_K, TILE_M * TILE_N, TILE_M * TILE_N);
+	// One core per cycle, and one step of every output tile per cycle with
+	// a single fill and drain of the array
+	printf("Cycles per call (II=1): DotTree %d, Systolic %d\n",
+		(DIM_M / TILE_M) * (DIM_N / TILE_N) * (DIM_K / TILE_K),
+		(DIM_M / TILE_M) * (DIM_N / TILE_N) * DIM_K + TILE_M + TILE_N - 2);
+	return 0;
+}
+
+int test_gemv(){
+	mat_t<counted, DIM_M, DIM_K> a = genmat<DIM_M, DIM_K>();
+	std::array<counted, DIM_K> x = genmat<1, DIM_K>()[0];
+	std::array<counted, DIM_M> gold = hw_synth_for_gemv(a, x);
+	std::array<counted, DIM_M> tree = hw_synth_gemv_tree(a, x);
+	std::array<counted, DIM_M> sys = hw_synth_gemv_systolic(a, x);
+	std::array<counted, DIM_M> core = gemv<Systolic>(a, x);
+	for(std::size_t i = 0; i < DIM_M; ++i){
+		if(tree[i].v != gold[i].v || sys[i].v != gold[i].v || core[i].v != gold[i].v){
+			fprintf(stderr, "Error! Gemv returned the incorrect value at %d. Gold: %d, DotTree: %d, Systolic: %d, Untiled: %d\n", 
+				(int)i, gold[i].v, tree[i].v, sys[i].v, core[i].v);
+			return -1;
+		}
+	}
+	printf("Gemv (DotTree, Systolic) Test Passed!\n");
+
+	const long macs = (long)DIM_M * DIM_K;
+	counted::mults = counted::adds = 0;
+	printf("Gemv %dx%d, %dx%d core:\n", DIM_M, DIM_K, TILE_M, TILE_K);
+	report("for", bench([&](){ gold = hw_synth_for_gemv(a, x); }), macs);
+	report("DotTree", bench([&](){ tree = hw_synth_gemv_tree(a, x); }), macs);
+	report("Systolic", bench([&](){ sys = hw_synth_gemv_systolic(a, x); }), macs);
+	printf("Cycles per call (II=1): DotTree %d, Systolic %d\n",
+		(DIM_M / TILE_M) * (DIM_K / TILE_K), (DIM_M / TILE_M) * DIM_K + TILE_M - 1);
+	return 0;
+}
+
+// Writes rows and reads columns of an R x C corner turn, and checks that
+// every row and column is spread over distinct banks
+template <std::size_t R, std::size_t C>
+int test_corner_turn_rc(){
+	typedef corner_turn<int, R, C> ct_t;
+	ct_t ct;
+	std::array<std::array<int, C>, R> in;
+	for(std::size_t r = 0; r < R; ++r){
+		for(std::size_t c = 0; c < C; ++c){
+			in[r][c] = r * C + c;
+		}
+		ct.write_row(r, in[r]);
+	}
+	std::array<std::array<int, R>, C> gold = transpose(in);
+	for(std::size_t c = 0; c < C; ++c){
+		if(ct.read_col(c) != gold[c]){
+			fprintf(stderr, "Error! %dx%d corner turn returned the wrong column %d\n", (int)R, (int)C, (int)c);
+			return -1;
+		}
+		ct.write_col(c, gold[c]);
+	}
+	for(std::size_t r = 0; r < R; ++r){
+		if(ct.read_row(r) != in[r]){
+			fprintf(stderr, "Error! %dx%d corner turn returned the wrong row %d\n", (int)R, (int)C, (int)r);
+			return -1;
+		}
+	}
+
+	std::array<std::array<bool, ct_t::DEPTH>, ct_t::BANKS> used = {};
+	for(std::size_t r = 0; r < R; ++r){
+		std::array<bool, ct_t::BANKS> row = {};
+		for(std::size_t c = 0; c < C; ++c){
+			if(row[ct_t::bank(r, c)] || used[ct_t::bank(r, c)][ct_t::addr(r, c)]){
+				fprintf(stderr, "Error! %dx%d corner turn has a conflict at (%d, %d)\n", (int)R, (int)C, (int)r, (int)c);
+				return -1;
+			}
+			row[ct_t::bank(r, c)] = used[ct_t::bank(r, c)][ct_t::addr(r, c)] = true;
+		}
+	}
+	for(std::size_t c = 0; c < C; ++c){
+		std::array<bool, ct_t::BANKS> col = {};
+		for(std::size_t r = 0; r < R; ++r){
+			if(col[ct_t::bank(r, c)]){
+				fprintf(stderr, "Error! %dx%d corner turn column %d has a bank conflict\n", (int)R, (int)C, (int)c);
+				return -1;
+			}
+			col[ct_t::bank(r, c)] = true;
+		}
+	}
+	return 0;
+}
+
+int test_corner_turn(){
+	if(test_corner_turn_rc<8, 8>() || test_corner_turn_rc<4, 8>() || test_corner_turn_rc<8, 3>()){
+		return -1;
+	}
+	printf("Corner turn Test Passed!\n");
+	return 0;
+}
+
+int main(){
+	int err;
+	if((err = test_matmul())){
+		return err;
+	}
+	if((err = test_gemv())){
+		return err;
+	}
+	if((err = test_corner_turn())){
+		return err;
+	}
+	printf("Matrix Tests passed\n");
+	return 0;	
+}
@@ -0,0 +1,217 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#include <array>
+#include <chrono>
+#include "listops.hpp"
+#include "reduce.hpp"
+#include "zip.hpp"
+#include "divconq.hpp"
+#include "permute.hpp"
+#include "testops.hpp"
+#ifdef BIT_ACCURATE
+#include "ap_int.h"
+#endif
+
+#define LOG_LIST_LENGTH 6
+#define LIST_LENGTH (1<<LOG_LIST_LENGTH)
+#define STRIDE 4
+#define ROWS 8
+#define COLS (LIST_LENGTH/ROWS)
+#define BENCH_ITERS 10000
+
+// Permutation indices are constant expressions
+static_assert(BitReversePerm::index(8, 1) == 4, "BitReversePerm is not constexpr");
+static_assert(ShufflePerm::index(8, 3) == 5, "ShufflePerm is not constexpr");
+static_assert(StridePerm<2>::index(8, 1) == 2, "StridePerm is not constexpr");
+static_assert(TransposePerm<2, 4>::index(8, 1) == 4, "TransposePerm is not constexpr");
+static_assert(DigitReversePerm::index(12, 1) == 4, "DigitReversePerm is not constexpr");
+
+class Interleave{
+public:
+	template <typename T, std::size_t LEN>
+	std::array<T, 2*LEN> operator()(std::array<T, LEN> L, std::array<T, LEN> R){
+#pragma HLS INLINE
+#pragma HLS ARRAY_PARTITION complete VARIABLE=L._M_instance
+#pragma HLS ARRAY_PARTITION complete VARIABLE=R._M_instance
+		std::array<T, 0> init;
+		return rreduce<Merge>(zipWith<Array>(L, R), init);
+	}
+};
+
+std::array<std::size_t, LIST_LENGTH> hw_synth_permute_bit_reverse(std::array<std::size_t, LIST_LENGTH> IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+	return permute<BitReversePerm>(IN);
+}
+
+std::array<std::size_t, LIST_LENGTH> hw_synth_divconq_bit_reverse(std::array<std::size_t, LIST_LENGTH> IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+	return divconq<Interleave>(IN);
+}
+
+std::array<std::size_t, LIST_LENGTH> hw_synth_permute_shuffle(std::array<std::size_t, LIST_LENGTH> IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+	return permute<ShufflePerm>(IN);
+}
+
+std::array<std::size_t, LIST_LENGTH> hw_synth_permute_stride(std::array<std::size_t, LIST_LENGTH> IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+	return permute<StridePerm<STRIDE>>(IN);
+}
+
+std::array<std::size_t, LIST_LENGTH> hw_synth_permute_transpose(std::array<std::size_t, LIST_LENGTH> IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+	return permute<TransposePerm<ROWS, COLS>>(IN);
+}
+
+int check(const char * NAME, std::array<std::size_t, LIST_LENGTH> const& OUT, std::array<std::size_t, LIST_LENGTH> const& GOLD){
+	for(int i = 0; i < LIST_LENGTH; ++i){
+		if(OUT[i] != GOLD[i]){
+			fprintf(stderr, "Error! %s did not produce the correct value at index %d. Output: %d, Gold: %d\n", NAME, i, (int)OUT[i], (int)GOLD[i]);
+			return -1;
+		}
+	}
+	printf("%s Test Passed!\n", NAME);
+	return 0;
+}
+
+int test_bit_reverse(){
+	auto in = range<LIST_LENGTH>();
+	std::array<std::size_t, LIST_LENGTH> gold;
+	for(std::size_t i = 0; i < LIST_LENGTH; ++i){
+		std::size_t b = 0;
+		for(std::size_t j = 0; j < LOG_LIST_LENGTH; ++j){
+			b = (b << 1) | ((i >> j) & 1);
+		}
+		gold[i] = b;
+	}
+	if(check("Bit-Reverse (permute)", hw_synth_permute_bit_reverse(in), gold) ||
+		check("Bit-Reverse (divconq)", hw_synth_divconq_bit_reverse(in), gold)){
+		return -1;
+	}
+
+	std::array<std::size_t, LIST_LENGTH> out;
+	auto start = std::chrono::high_resolution_clock::now();
+	for(int i = 0; i < BENCH_ITERS; ++i){
+		out = hw_synth_permute_bit_reverse(in);
+	}
+	auto mid = std::chrono::high_resolution_clock::now();
+	for(int i = 0; i < BENCH_ITERS; ++i){
+		out = hw_synth_divconq_bit_reverse(in);
+	}
+	auto stop = std::chrono::high_resolution_clock::now();
+	printf("Bit-Reverse C-sim time: permute %.2f us/call, divconq %.2f us/call\n",
+		std::chrono::duration<double>(mid - start).count() * 1e6 / BENCH_ITERS,
+		std::chrono::duration<double>(stop - mid).count() * 1e6 / BENCH_ITERS);
+	return 0;
+}
+
+// Digit reversal is bit reversal for powers of two, and a permutation of
+// every other length
+template <std::size_t LEN>
+int test_digit_reverse_len(){
+	std::array<bool, LEN> seen = {};
+	for(std::size_t i = 0; i < LEN; ++i){
+		std::size_t d = DigitReversePerm::index(LEN, i);
+		if(d >= LEN || seen[d]){
+			fprintf(stderr, "Error! Digit-Reverse of length %d is not a permutation at index %d\n", (int)LEN, (int)i);
+			return -1;
+		}
+		seen[d] = true;
+	}
+	return 0;
+}
+
+int test_digit_reverse(){
+	auto in = range<LIST_LENGTH>();
+	if(check("Digit-Reverse (permute)", permute<DigitReversePerm>(in), permute<BitReversePerm>(in)) ||
+		test_digit_reverse_len<12>() || test_digit_reverse_len<60>() || test_digit_reverse_len<1536>() || 
+		test_digit_reverse_len<7>() || test_digit_reverse_len<98>()){
+		return -1;
+	}
+	return 0;
+}
+
+int test_shuffle(){
+	auto in = range<LIST_LENGTH>();
+	std::array<std::size_t, LIST_LENGTH> gold;
+	for(std::size_t i = 0; i < LIST_LENGTH / 2; ++i){
+		gold[2*i] = in[i];
+		gold[2*i + 1] = in[LIST_LENGTH / 2 + i];
+	}
+	return check("Perfect Shuffle (permute)", hw_synth_permute_shuffle(in), gold);
+}
+
+int test_stride(){
+	auto in = range<LIST_LENGTH>();
+	std::array<std::size_t, LIST_LENGTH> gold;
+	for(std::size_t s = 0, idx = 0; s < STRIDE; ++s){
+		for(std::size_t i = s; i < LIST_LENGTH; i += STRIDE, ++idx){
+			gold[idx] = in[i];
+		}
+	}
+	return check("Stride (permute)", hw_synth_permute_stride(in), gold);
+}
+
+int test_transpose(){
+	auto in = range<LIST_LENGTH>();
+	std::array<std::size_t, LIST_LENGTH> gold;
+	for(std::size_t r = 0; r < ROWS; ++r){
+		for(std::size_t c = 0; c < COLS; ++c){
+			gold[c * ROWS + r] = in[r * COLS + c];
+		}
+	}
+	return check("Transpose (permute)", hw_synth_permute_transpose(in), gold);
+}
+
+int main(){
+	int err;
+	if((err = test_bit_reverse())){
+		return err;
+	}
+	if((err = test_digit_reverse())){
+		return err;
+	}
+	if((err = test_shuffle())){
+		return err;
+	}
+	if((err = test_stride())){
+		return err;
+	}
+	if((err = test_transpose())){
+		return err;
+	}
+	printf("Permute Tests passed\n");
+	return 0;	
+}
@@ -0,0 +1,241 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#include <array>
+#include <chrono>
+#include <cmath>
+#include "policy.hpp"
+#include "map.hpp"
+#include "zip.hpp"
+#include "reduce.hpp"
+#include "divconq.hpp"
+#include "testops.hpp"
+#ifdef BIT_ACCURATE
+#include "ap_int.h"
+#endif
+
+#define LOG_LIST_LENGTH 6
+#define LIST_LENGTH (1<<LOG_LIST_LENGTH)
+#define FOLD 4
+// Each map returns its list by value, so the benchmark lists are kept
+// well below the stack size
+#define LOG_BENCH_LENGTH 16
+#define BENCH_LENGTH (1<<LOG_BENCH_LENGTH)
+
+class Square{
+public:
+	int operator()(int IN){
+		return IN * IN;
+	}
+};
+
+class Add{
+public:
+	int operator()(std::array<int, 1> L, std::array<int, 1> R){
+		return L[0] + R[0];
+	}
+	int operator()(int L, int R){
+		return L + R;
+	}
+};
+
+template <>
+struct is_associative<Add> : std::true_type{};
+
+template <>
+struct is_commutative<Add> : std::true_type{};
+
+class Sub{
+public:
+	int operator()(int L, int R){
+		return L - R;
+	}
+};
+
+// A deliberately expensive element-wise functor, for the host benchmark
+class Slow{
+public:
+	float operator()(float IN){
+		float r = IN;
+		for(int i = 0; i < 1024; ++i){
+			r = std::sqrt(r * r + 1.0f);
+		}
+		return r;
+	}
+};
+
+std::array<int, LIST_LENGTH> hw_synth_map_folded(std::array<int, LIST_LENGTH> IN){
+	return map<Square, folded<FOLD>>(IN);
+}
+
+std::array<int, LIST_LENGTH> hw_synth_zipwith_streaming(std::array<int, LIST_LENGTH> L, std::array<int, LIST_LENGTH> R){
+	return zipWith<Sub, streaming>(L, R);
+}
+
+int hw_synth_reduce_folded(std::array<int, LIST_LENGTH> IN){
+	return reduce<Add, folded<FOLD>>(0, IN);
+}
+
+int hw_synth_rreduce_folded(std::array<int, LIST_LENGTH> IN){
+	return rreduce<Sub, folded<FOLD>>(IN, 0);
+}
+
+int hw_synth_divconq_folded(std::array<int, LIST_LENGTH> IN){
+	return divconq<Add, folded<FOLD>>(IN);
+}
+
+template <class POLICY>
+int test_policy(char const* NAME){
+	std::array<int, LIST_LENGTH> l = genarr<-1000, 1000, LIST_LENGTH>();
+	std::array<int, LIST_LENGTH> r = genarr<-1000, 1000, LIST_LENGTH>();
+
+	if(map<Square, POLICY>(l) != map<Square>(l)){
+		fprintf(stderr, "Error! Map (%s) did not match map\n", NAME);
+		return -1;
+	}
+	if(Map<Square, POLICY>()(l) != map<Square>(l)){
+		fprintf(stderr, "Error! Map functor (%s) did not match map\n", NAME);
+		return -1;
+	}
+	if(zipWith<Sub, POLICY>(l, r) != zipWith<Sub>(l, r)){
+		fprintf(stderr, "Error! ZipWith (%s) did not match zipWith\n", NAME);
+		return -1;
+	}
+	if(reduce<Add, POLICY>(7, l) != reduce<Add>(7, l)){
+		fprintf(stderr, "Error! Reduce Add (%s) did not match reduce\n", NAME);
+		return -1;
+	}
+	if(Reduce<Add, POLICY>()(7, l) != reduce<Add>(7, l)){
+		fprintf(stderr, "Error! Reduce functor (%s) did not match reduce\n", NAME);
+		return -1;
+	}
+	if(reduce<Sub, POLICY>(7, l) != reduce<Sub>(7, l)){
+		fprintf(stderr, "Error! Reduce Sub (%s) did not match reduce\n", NAME);
+		return -1;
+	}
+	if(rreduce<Add, POLICY>(l, 7) != rreduce<Add>(l, 7)){
+		fprintf(stderr, "Error! Rreduce Add (%s) did not match rreduce\n", NAME);
+		return -1;
+	}
+	if(rreduce<Sub, POLICY>(l, 7) != rreduce<Sub>(l, 7)){
+		fprintf(stderr, "Error! Rreduce Sub (%s) did not match rreduce\n", NAME);
+		return -1;
+	}
+	if(divconq<Add, POLICY>(l) != divconq<Add>(l)){
+		fprintf(stderr, "Error! Divconq (%s) did not match divconq\n", NAME);
+		return -1;
+	}
+	printf("Policy %s Test Passed!\n", NAME);
+	return 0;
+}
+
+int test_synth(){
+	std::array<int, LIST_LENGTH> l = genarr<-1000, 1000, LIST_LENGTH>();
+	std::array<int, LIST_LENGTH> r = genarr<-1000, 1000, LIST_LENGTH>();
+	int sum = 0, rsub = 0;
+	for(int i = 0; i < LIST_LENGTH; ++i){
+		sum += l[i];
+	}
+	for(int i = LIST_LENGTH - 1; i >= 0; --i){
+		rsub = l[i] - rsub;
+	}
+
+	std::array<int, LIST_LENGTH> sq = hw_synth_map_folded(l);
+	std::array<int, LIST_LENGTH> diff = hw_synth_zipwith_streaming(l, r);
+	for(int i = 0; i < LIST_LENGTH; ++i){
+		if(sq[i] != l[i] * l[i] || diff[i] != l[i] - r[i]){
+			fprintf(stderr, "Error! Map/ZipWith returned the incorrect value at index %d\n", i);
+			return -1;
+		}
+	}
+	if(hw_synth_reduce_folded(l) != sum || hw_synth_divconq_folded(l) != sum){
+		fprintf(stderr, "Error! Reduce/Divconq (folded) did not match a for-loop sum\n");
+		return -1;
+	}
+	if(hw_synth_rreduce_folded(l) != rsub){
+		fprintf(stderr, "Error! Rreduce (folded) did not match a for-loop difference\n");
+		return -1;
+	}
+	printf("Synthesis Functions Test Passed!\n");
+	return 0;
+}
+
+std::array<float, BENCH_LENGTH> bench_in;
+std::array<float, BENCH_LENGTH> bench_seq;
+std::array<float, BENCH_LENGTH> bench_par;
+
+int bench_host_par(){
+	for(int i = 0; i < BENCH_LENGTH; ++i){
+		bench_in[i] = i;
+	}
+	auto start = std::chrono::high_resolution_clock::now();
+	bench_seq = map<Slow, streaming>(bench_in);
+	auto mid = std::chrono::high_resolution_clock::now();
+	bench_par = map<Slow, host_par>(bench_in);
+	auto stop = std::chrono::high_resolution_clock::now();
+
+	if(bench_seq != bench_par){
+		fprintf(stderr, "Error! Map (host_par) did not match map (streaming)\n");
+		return -1;
+	}
+	double seq = std::chrono::duration<double>(mid - start).count();
+	double par = std::chrono::duration<double>(stop - mid).count();
+	printf("Map host_par Benchmark Passed! %d items, sequential: %f s, host_par: %f s (%.2fx on %u threads)\n",
+		BENCH_LENGTH, seq, par, seq / par, std::thread::hardware_concurrency());
+	return 0;
+}
+
+int main(){
+	int err;
+	if((err = test_policy<unrolled>("unrolled"))){
+		return err;
+	}
+	if((err = test_policy<folded<FOLD>>("folded"))){
+		return err;
+	}
+	if((err = test_policy<streaming>("streaming"))){
+		return err;
+	}
+	if((err = test_policy<host_par>("host_par"))){
+		return err;
+	}
+	if((err = test_synth())){
+		return err;
+	}
+	if((err = bench_host_par())){
+		return err;
+	}
+	printf("Policy Tests passed\n");
+	return 0;
+}
@@ -33,10 +33,13 @@
 // DAMAGE.
 // ----------------------------------------------------------------------
 #include <array>
+#include <limits>
+#include <chrono>
 #include "listops.hpp"
 #include "hof.hpp"
 #include "reduce.hpp"
 #include "zip.hpp"
+#include "stream.hpp"
 #include "testops.hpp"
 #ifdef BIT_ACCURATE
 #include "ap_int.h"
@@ -45,6 +48,25 @@
 #define MULTCONST 35
 #define LOG_LIST_LENGTH 6
 #define LIST_LENGTH (1<<LOG_LIST_LENGTH)
+#define LOG_STREAM_LENGTH 16
+#define STREAM_LENGTH (1<<LOG_STREAM_LENGTH)
+#define LANES 8
+#define LOG_BENCH_LENGTH 12
+#define BENCH_LENGTH (1<<LOG_BENCH_LENGTH)
+#define CHAIN_BENCH_LENGTH 512
+#define BENCH_ITERS 100
+
+// Marks FTOR associative and commutative, so that reduce and rreduce build
+// balanced trees and sreduce can use several lanes. Min and Add are left
+// unmarked, so the designs that use them directly are chains.
+template <class FTOR>
+struct Assoc : FTOR{};
+
+template <class FTOR>
+struct is_associative<Assoc<FTOR> > : std::true_type{};
+
+template <class FTOR>
+struct is_commutative<Assoc<FTOR> > : std::true_type{};
 
 // -------------------- Min --------------------
 class Min{
@@ -57,6 +79,15 @@ public:
 	}
 };
 
+
+template <>
+struct identity<Min>{
+	template <typename T>
+	static constexpr T value(){
+		return std::numeric_limits<T>::max();
+	}
+};
+
 int hw_synth_for_min(std::array<int, LIST_LENGTH> IN){
 #pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
 #pragma HLS PIPELINE
@@ -82,6 +113,18 @@ int hw_synth_rreduce_min(std::array<int, LIST_LENGTH> IN){
 	return rreduce<Min>(IN, 1001);
 }
 
+int hw_synth_reduce_min_tree(std::array<int, LIST_LENGTH> IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS PIPELINE
+	return reduce<Assoc<Min>>(1001, IN);
+}
+
+int hw_synth_reduce_min_identity(std::array<int, LIST_LENGTH> IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS PIPELINE
+	return reduce<Min>(IN);
+}
+
 int test_min(){
 	int output = 0, gold = 1001, init = 0;
 	std::array<int, LIST_LENGTH> in = genarr<-1000, 1000, LIST_LENGTH>();
@@ -105,6 +148,20 @@ int test_min(){
 	}
 	printf("Min (rreduce) Test Passed!\n");
 
+	output = hw_synth_reduce_min_tree(in);
+	if(output != gold){
+		fprintf(stderr, "Error! Min (reduce, tree) returned the incorrect value. Output: %d, Gold: %d\n", output, gold);
+		return -1;
+	}
+	printf("Min (reduce, tree) Test Passed!\n");
+
+	output = hw_synth_reduce_min_identity(in);
+	if(output != gold){
+		fprintf(stderr, "Error! Min (reduce, identity) returned the incorrect value. Output: %d, Gold: %d\n", output, gold);
+		return -1;
+	}
+	printf("Min (reduce, identity) Test Passed!\n");
+
 	output = hw_synth_for_min(in);
 	if(output != gold){
 		fprintf(stderr, "Error! Min (for) returned the incorrect value. Output: %d, Gold: %d\n", output, gold);
@@ -120,15 +177,16 @@ int test_min(){
 class Add{
 public:
 	template <typename T>
-	T operator()(std::array<T, 1> L, std::array<T, 1> R){
+	CONSTEXPR17 T operator()(std::array<T, 1> L, std::array<T, 1> R){
 		return L[0] + R[0];
 	}
 	template <typename T>
-	T operator()(T L, T R){
+	CONSTEXPR17 T operator()(T L, T R){
 		return L + R;
 	}
 };
 
+
 float hw_synth_reduce_add(std::array<float, LIST_LENGTH> IN){
 #pragma HLS PIPELINE
 	return reduce<Add>(0.0f, IN);
@@ -139,6 +197,31 @@ float hw_synth_rreduce_add(std::array<float, LIST_LENGTH> IN){
 	return rreduce<Add>(IN, 0.0f);
 }
 
+float hw_synth_reduce_add_tree(std::array<float, LIST_LENGTH> IN){
+#pragma HLS PIPELINE
+	return reduce<Assoc<Add>>(0.0f, IN);
+}
+
+float hw_synth_rreduce_add_tree(std::array<float, LIST_LENGTH> IN){
+#pragma HLS PIPELINE
+	return rreduce<Assoc<Add>>(IN, 0.0f);
+}
+
+// Adds operands of different types, e.g. a long long sum and an int element
+struct AddMixed{
+	template <typename TL, typename TR>
+	CONSTEXPR17 auto operator()(TL L, TR R) -> decltype(L + R){
+		return L + R;
+	}
+};
+
+// A long long sum of ints: INIT is wider than the elements, so reduce
+// accumulates in long long with a chain, even for an associative functor
+long long hw_synth_reduce_add_wide(std::array<int, LIST_LENGTH> IN){
+#pragma HLS PIPELINE
+	return reduce<Assoc<AddMixed>>(0LL, IN);
+}
+
 float hw_synth_for_add(std::array<float, LIST_LENGTH> IN){
 #pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
 #pragma HLS PIPELINE
@@ -173,6 +256,21 @@ float test_sum(){
 	}
 	printf("Sum (reduce) Test Passed!\n");
 
+	// The inputs are small integers, so the tree's sums are exact too
+	if(hw_synth_reduce_add_tree(in) != gold || hw_synth_rreduce_add_tree(in) != gold){
+		fprintf(stderr, "Error! Sum (reduce/rreduce, tree) returned the incorrect value\n");
+		return -1;
+	}
+	printf("Sum (reduce/rreduce, tree) Test Passed!\n");
+
+	std::array<int, LIST_LENGTH> big;
+	big.fill(std::numeric_limits<int>::max());
+	if(hw_synth_reduce_add_wide(big) != (long long)std::numeric_limits<int>::max() * LIST_LENGTH){
+		fprintf(stderr, "Error! Sum (reduce, long long of int) overflowed\n");
+		return -1;
+	}
+	printf("Sum (reduce, long long of int) Test Passed!\n");
+
 	output = hw_synth_for_add(in);
 	if(output != gold){
 		fprintf(stderr, "Error! Sum (for) returned the incorrect value. Output: %f, Gold: %f\n", output, gold);
@@ -182,8 +280,98 @@ float test_sum(){
 	
 	return 0;
 }
+
+float hw_synth_sreduce_add(stream<float>& IN){
+#pragma HLS INTERFACE axis port=IN
+	return sreduce<Assoc<Add>, LANES>(0.0f, STREAM_LENGTH, IN);
+}
+
+float hw_synth_for_sadd(stream<float>& IN){
+#pragma HLS INTERFACE axis port=IN
+	float out = 0;
+	for(int i = 0; i < STREAM_LENGTH; ++i){
+#pragma HLS PIPELINE
+		out += IN.read();
+	}
+	return out;
+}
+
+stream<float> sum_stream;
+
+int test_stream_sum(){
+	float output = 0, gold = 0;
+	std::array<int, STREAM_LENGTH> input = genarr<-100, 100, STREAM_LENGTH>();
+	for(int i = 0; i < STREAM_LENGTH; ++i){
+		gold += input[i];
+		sum_stream.write(input[i]);
+	}
+
+	output = hw_synth_sreduce_add(sum_stream);
+	if(output != gold){
+		fprintf(stderr, "Error! Sum (sreduce) returned the incorrect value. Output: %f, Gold: %f\n", output, gold);
+		return -1;
+	}
+	printf("Sum (sreduce) Test Passed!\n");
+
+	for(int i = 0; i < STREAM_LENGTH; ++i){
+		sum_stream.write(input[i]);
+	}
+	output = hw_synth_for_sadd(sum_stream);
+	if(output != gold){
+		fprintf(stderr, "Error! Sum (stream for) returned the incorrect value. Output: %f, Gold: %f\n", output, gold);
+		return -1;
+	}
+	printf("Sum (stream for) Test Passed!\n");
+	return 0;
+}
 // -------------------- End Add --------------------
 
+// -------------------- Sub --------------------
+// Subtraction is not associative, so reduce and rreduce must stay chains
+class Sub{
+public:
+	CONSTEXPR17 int operator()(int L, int R){
+		return L - R;
+	}
+};
+
+int hw_synth_reduce_sub(std::array<int, LIST_LENGTH> IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS PIPELINE
+	return reduce<Sub>(0, IN);
+}
+
+int hw_synth_rreduce_sub(std::array<int, LIST_LENGTH> IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS PIPELINE
+	return rreduce<Sub>(IN, 0);
+}
+
+int test_sub(){
+	std::array<int, LIST_LENGTH> in = genarr<-1000, 1000, LIST_LENGTH>();
+	int lgold = 0, rgold = 0;
+	for(int i = 0; i < LIST_LENGTH; ++i){
+		lgold = lgold - in[i];
+		rgold = in[LIST_LENGTH - i - 1] - rgold;
+	}
+
+	int output = hw_synth_reduce_sub(in);
+	if(output != lgold){
+		fprintf(stderr, "Error! Sub (reduce) returned the incorrect value. Output: %d, Gold: %d\n", output, lgold);
+		return -1;
+	}
+	printf("Sub (reduce) Test Passed!\n");
+
+	output = hw_synth_rreduce_sub(in);
+	if(output != rgold){
+		fprintf(stderr, "Error! Sub (rreduce) returned the incorrect value. Output: %d, Gold: %d\n", output, rgold);
+		return -1;
+	}
+	printf("Sub (rreduce) Test Passed!\n");
+	return 0;
+}
+// -------------------- End Sub --------------------
+
 // -------------------- Map --------------------
 template <class FTOR>
 class RMap{
@@ -432,16 +620,81 @@ int test_interleave(){
 
 // -------------------- End Interleave --------------------
 
+// -------------------- Begin Benchmark --------------------
+std::array<float, BENCH_LENGTH> bench_tree;
+std::array<int, CHAIN_BENCH_LENGTH> bench_chain;
+
+// Host (C-sim) run time of a long tree (Assoc<Add>) and chain (Sub) reduction
+int bench_reduce(){
+	float tree_gold = 0, tree_out = 0;
+	int chain_gold = 0, chain_out = 0;
+	for(int i = 0; i < BENCH_LENGTH; ++i){
+		bench_tree[i] = i % 7;
+		tree_gold += bench_tree[i];
+	}
+	for(int i = 0; i < CHAIN_BENCH_LENGTH; ++i){
+		bench_chain[i] = i % 5;
+		chain_gold -= bench_chain[i];
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for(int i = 0; i < BENCH_ITERS; ++i){
+		tree_out = reduce<Assoc<Add>>(0.0f, bench_tree);
+	}
+	auto mid = std::chrono::high_resolution_clock::now();
+	for(int i = 0; i < BENCH_ITERS; ++i){
+		chain_out = reduce<Sub>(0, bench_chain);
+	}
+	auto stop = std::chrono::high_resolution_clock::now();
+
+	if(tree_out != tree_gold || chain_out != chain_gold){
+		fprintf(stderr, "Error! Benchmark reductions returned the incorrect value\n");
+		return -1;
+	}
+	printf("Reduce C-sim time: %d-element tree %.1f us/call, %d-element chain %.1f us/call\n",
+		BENCH_LENGTH, std::chrono::duration<double>(mid - start).count() * 1e6 / BENCH_ITERS,
+		CHAIN_BENCH_LENGTH, std::chrono::duration<double>(stop - mid).count() * 1e6 / BENCH_ITERS);
+	return 0;
+}
+// -------------------- End Benchmark --------------------
+
+// -------------------- Begin Constexpr --------------------
+// Under C++17 reduce, rreduce and treereduce can be evaluated at compile
+// time, with both the tree (Assoc<Add>) and chain (Sub) forms
+int test_constexpr(){
+#if __cplusplus >= 201703L
+	constexpr std::size_t sum = reduce<Assoc<Add>>(std::size_t(0), range<LIST_LENGTH>());
+	constexpr std::size_t tsum = treereduce<Add>(range<LIST_LENGTH>());
+	constexpr int sub = reduce<Sub>(0, replicate<LIST_LENGTH>(3));
+	constexpr int rsub = rreduce<Sub>(replicate<LIST_LENGTH>(3), 1);
+	static_assert(sum == LIST_LENGTH * (LIST_LENGTH - 1) / 2, "Constexpr reduce<Add> is incorrect");
+	static_assert(tsum == sum, "Constexpr treereduce<Add> is incorrect");
+	static_assert(sub == -3 * LIST_LENGTH, "Constexpr reduce<Sub> is incorrect");
+	static_assert(rsub == 1, "Constexpr rreduce<Sub> is incorrect");
+	printf("Constexpr Reduce Test Passed!\n");
+#endif
+	return 0;
+}
+// -------------------- End Constexpr --------------------
+
 int main(){
 	int err;
 	if((err = test_sum())){
 		return err;
 	}
 
+	if((err = test_stream_sum())){
+		return err;
+	}
+
 	if((err = test_min())){
 		return err;
 	}
 
+	if((err = test_sub())){
+		return err;
+	}
+
 	if((err = test_map())){
 		return err;
 	}
@@ -453,6 +706,14 @@ int main(){
 	if((err = test_interleave())){
 		return err;
 	}
+
+	if((err = test_constexpr())){
+		return err;
+	}
+
+	if((err = bench_reduce())){
+		return err;
+	}
 	
 	printf("Reduce/rreduce Tests passed\n");
 	return 0;	
@@ -0,0 +1,172 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#include <utility>
+#include <array>
+#include <tuple>
+#include "listops.hpp"
+#include "hof.hpp"
+#include "map.hpp"
+#include "zip.hpp"
+#include "soa.hpp"
+#include "testops.hpp"
+#define LOG_LIST_LENGTH 6
+#define LIST_LENGTH (1<<LOG_LIST_LENGTH)
+
+class Fma{
+public:
+	int operator()(int A, int B, int C){
+#pragma HLS INLINE
+		return A * B + C;
+	}
+};
+
+class Add{
+public:
+	int operator()(int L, int R){
+#pragma HLS INLINE
+		return L + R;
+	}
+};
+
+// Applies FTOR to the fields of a tuple
+template <class FTOR>
+struct Untuple3{
+	template <typename TA, typename TB, typename TC>
+	auto operator()(std::tuple<TA, TB, TC> const& IN) -> decltype(FTOR()(std::get<0>(IN), std::get<1>(IN), std::get<2>(IN))){
+#pragma HLS INLINE
+		return FTOR()(std::get<0>(IN), std::get<1>(IN), std::get<2>(IN));
+	}
+};
+
+typedef soa_array<LIST_LENGTH, int, int, int> soa3_t;
+typedef std::array<std::tuple<int, int, int>, LIST_LENGTH> aos3_t;
+
+// The struct-of-arrays form keeps each field in its own plane, which HLS
+// can partition independently
+std::array<int, LIST_LENGTH> hw_synth_soa_fma(soa3_t const& IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN.planes
+#pragma HLS PIPELINE
+	return map<Fma>(IN);
+}
+
+std::array<int, LIST_LENGTH> hw_synth_aos_fma(aos3_t const& IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS PIPELINE
+	return map<Untuple3<Fma>>(IN);
+}
+
+std::array<int, LIST_LENGTH> hw_synth_soa_zipwith(soa_array<LIST_LENGTH, int, int> const& IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN.planes
+#pragma HLS PIPELINE
+	return zipWith<Add>(IN);
+}
+
+int test_soa_zip(){
+	std::array<int, LIST_LENGTH> a = genarr<-1000, 1000, LIST_LENGTH>();
+	std::array<int, LIST_LENGTH> b = genarr<-1000, 1000, LIST_LENGTH>();
+	soa_array<LIST_LENGTH, int, int> zipped = zip_soa(a, b);
+
+	auto planes = unzip(zipped);
+	if(&planes.first != &zipped.get<0>() || &planes.second != &zipped.get<1>()){
+		printf("Error! unzip of a soa_array copied its planes\n");
+		return -1;
+	}
+	if(planes.first != a || planes.second != b){
+		printf("Error! unzip of a soa_array did not invert zip_soa\n");
+		return -1;
+	}
+	if(&std::get<1>(unzipN(zipped)) != &zipped.get<1>()){
+		printf("Error! unzipN of a soa_array copied its planes\n");
+		return -1;
+	}
+	// A temporary soa_array is unzipped by value, not into references
+	// that would dangle once it is destroyed
+	std::pair<std::array<int, LIST_LENGTH>, std::array<int, LIST_LENGTH>> owned = unzip(zip_soa(a, b));
+	if(owned.first != a || owned.second != b || std::get<0>(unzipN(zip_soa(a, b))) != a){
+		printf("Error! unzip of a temporary soa_array did not invert zip_soa\n");
+		return -1;
+	}
+	for(int i = 0; i < LIST_LENGTH; ++i){
+		if(zipped[i] != std::make_tuple(a[i], b[i])){
+			printf("Error! soa_array element %d was incorrect\n", i);
+			return -1;
+		}
+	}
+
+	zipped.set(3, std::make_tuple(7, 11));
+	if(zipped.get<0>()[3] != 7 || zipped.get<1>()[3] != 11){
+		printf("Error! soa_array set did not update both planes\n");
+		return -1;
+	}
+	printf("Zip/Unzip (soa) Test Passed!\n");
+	return 0;
+}
+
+int test_soa_map(){
+	std::array<int, LIST_LENGTH> a = genarr<-1000, 1000, LIST_LENGTH>();
+	std::array<int, LIST_LENGTH> b = genarr<-1000, 1000, LIST_LENGTH>();
+	std::array<int, LIST_LENGTH> c = genarr<-1000, 1000, LIST_LENGTH>();
+	soa3_t soa = zip_soa(a, b, c);
+	aos3_t aos = zipN(a, b, c);
+
+	if(to_aos(soa) != aos || to_soa(aos).planes != soa.planes){
+		printf("Error! soa_array/array-of-tuples conversion was incorrect\n");
+		return -1;
+	}
+
+	std::array<int, LIST_LENGTH> gold = zipWithN<Fma>(a, b, c);
+	if(hw_synth_soa_fma(soa) != gold || hw_synth_aos_fma(aos) != gold){
+		printf("Error! Map (soa) did not match zipWithN\n");
+		return -1;
+	}
+	if(hw_synth_soa_zipwith(zip_soa(a, b)) != zipWith<Add>(a, b)){
+		printf("Error! ZipWith (soa) did not match zipWith\n");
+		return -1;
+	}
+	printf("Map/ZipWith (soa) Test Passed!\n");
+	return 0;
+}
+
+int main(){
+	int err;
+	if((err = test_soa_zip())){
+		return err;
+	}
+	if((err = test_soa_map())){
+		return err;
+	}
+	printf("SoA Tests passed\n");
+	return 0;	
+}
@@ -0,0 +1,274 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#include <array>
+#include <chrono>
+#include <climits>
+#include <random>
+#include <algorithm>
+#include "sparse.hpp"
+#include "map.hpp"
+#include "zip.hpp"
+#include "reduce.hpp"
+#include "traits.hpp"
+#include "testops.hpp"
+
+#define ROWS 64
+#define COLS 64
+#define MAX_NNZ 512
+#define BENCH_ROWS 1024
+#define BENCH_COLS 1024
+#define BENCH_NNZ 32768
+#define BENCH_ITERS 16
+
+struct Add{
+	template <typename T>
+	T operator()(T const& L, T const& R){
+#pragma HLS INLINE
+		return L + R;
+	}
+};
+
+template <>
+struct is_associative<Add> : std::true_type{};
+
+template <>
+struct is_commutative<Add> : std::true_type{};
+
+// Not marked associative, so sparse_reduce can only use one lane (a chain)
+struct Max{
+	int operator()(int const& L, int const& R){
+#pragma HLS INLINE
+		return L > R ? L : R;
+	}
+};
+
+struct Mult{
+	template <typename T>
+	T operator()(T const& L, T const& R){
+#pragma HLS INLINE
+		return L * R;
+	}
+};
+
+struct Triple{
+	int operator()(int const& IN){
+#pragma HLS INLINE
+		return 3 * IN;
+	}
+};
+
+// The densified baseline: every row is a zipWith<Mult> and a reduce<Add>
+struct DenseRow{
+	template <typename T, std::size_t C>
+	T operator()(std::array<T, C> const& ROW, std::array<T, C> const& X){
+#pragma HLS INLINE
+		return reduce<Add>(T(), zipWith<Mult>(ROW, X));
+	}
+};
+
+template <typename T, std::size_t R, std::size_t C>
+std::array<T, R> dense_mv(std::array<std::array<T, C>, R> const& A, std::array<T, C> const& X){
+	std::array<T, R> y;
+	for(std::size_t r = 0; r < R; ++r){
+		y[r] = DenseRow()(A[r], X);
+	}
+	return y;
+}
+
+typedef csr_t<float, ROWS, COLS, MAX_NNZ> fcsr_t;
+typedef std::array<std::array<float, COLS>, ROWS> fdense_t;
+
+std::array<float, ROWS> hw_synth_spmv(fcsr_t const& A, std::array<float, COLS> const& X){
+	return spmv<4>(A, X);
+}
+
+std::array<float, ROWS> hw_synth_dense_mv(fdense_t const& A, std::array<float, COLS> const& X){
+	return dense_mv(A, X);
+}
+
+std::array<int, ROWS> hw_synth_sparse_reduce(csr_t<int, ROWS, COLS, MAX_NNZ> const& A){
+	return sparse_reduce<Add, 4>(0, A);
+}
+
+// A random R x C matrix with about DENSITY percent nonzeros (at most NNZ)
+template <typename T, std::size_t R, std::size_t C>
+void gen_sparse(std::array<std::array<T, C>, R>& OUT, int DENSITY, std::size_t NNZ, unsigned SEED){
+	std::mt19937 gen(SEED);
+	std::uniform_int_distribution<int> pct(0, 99), value(-50, 50);
+	std::size_t n = 0;
+	for(std::size_t r = 0; r < R; ++r){
+		for(std::size_t c = 0; c < C; ++c){
+			int v = value(gen);
+			OUT[r][c] = (pct(gen) < DENSITY && n < NNZ && v != 0) ? (T)v : T();
+			n += (OUT[r][c] != T());
+		}
+	}
+	// Leave an empty row
+	OUT[R / 2].fill(T());
+}
+
+std::array<std::array<int, COLS>, ROWS> dense;
+
+int test_convert(){
+	gen_sparse(dense, 10, MAX_NNZ, 50);
+	csr_t<int, ROWS, COLS, MAX_NNZ> csr = to_csr<MAX_NNZ>(dense);
+	coo_t<int, ROWS, COLS, MAX_NNZ> coo = to_coo<MAX_NNZ>(dense);
+	if(to_dense(csr) != dense || to_dense(coo) != dense || csr.nnz() != coo.nnz()){
+		fprintf(stderr, "Error! CSR or COO did not round-trip\n");
+		return -1;
+	}
+	// Reversing the coordinates keeps each row's nonzeros together but
+	// reverses their order; to_csr sorts the rows back
+	std::reverse(coo.row.begin(), coo.row.begin() + coo.nnz());
+	std::reverse(coo.col.begin(), coo.col.begin() + coo.nnz());
+	std::reverse(coo.val.begin(), coo.val.begin() + coo.nnz());
+	csr_t<int, ROWS, COLS, MAX_NNZ> sorted = to_csr(coo);
+	if(to_dense(sorted) != dense || sorted.rowptr != csr.rowptr){
+		fprintf(stderr, "Error! COO to CSR conversion did not match\n");
+		return -1;
+	}
+	// Too many nonzeros for the capacity: the first ones are kept, in
+	// row-major order, and the rest are reported as dropped
+	std::size_t csr_dropped, coo_dropped;
+	csr_t<int, ROWS, COLS, 4> small_csr = to_csr<4>(dense, csr_dropped);
+	coo_t<int, ROWS, COLS, 4> small_coo = to_coo<4>(dense, coo_dropped);
+	if(small_csr.nnz() != 4 || small_coo.nnz() != 4 ||
+	   csr_dropped != csr.nnz() - 4 || coo_dropped != csr.nnz() - 4 ||
+	   !std::equal(small_csr.val.begin(), small_csr.val.end(), csr.val.begin()) ||
+	   to_dense(small_csr) != to_dense(small_coo)){
+		fprintf(stderr, "Error! Conversion past the NNZ capacity was not truncated and reported\n");
+		return -1;
+	}
+	printf("CSR/COO conversion Test Passed! (%lu nonzeros of %d)\n", (unsigned long)csr.nnz(), ROWS * COLS);
+	return 0;
+}
+
+int test_map_reduce(){
+	csr_t<int, ROWS, COLS, MAX_NNZ> csr = to_csr<MAX_NNZ>(dense);
+	std::array<std::array<int, COLS>, ROWS> gold;
+	for(int r = 0; r < ROWS; ++r){
+		gold[r] = map<Triple>(dense[r]);
+	}
+	if(to_dense(sparse_map<Triple>(csr)) != gold || to_dense(sparse_map<Triple>(to_coo<MAX_NNZ>(dense))) != gold){
+		fprintf(stderr, "Error! sparse_map did not match map\n");
+		return -1;
+	}
+
+	std::array<int, ROWS> sums = hw_synth_sparse_reduce(csr);
+	std::array<int, ROWS> maxes = sparse_reduce<Max>(INT_MIN, csr);
+	for(int r = 0; r < ROWS; ++r){
+		int sum = reduce<Add>(0, dense[r]);
+		int max = INT_MIN;
+		for(int c = 0; c < COLS; ++c){
+			max = (dense[r][c] != 0 && dense[r][c] > max) ? dense[r][c] : max;
+		}
+		if(sums[r] != sum || maxes[r] != max){
+			fprintf(stderr, "Error! sparse_reduce returned the incorrect value for row %d. Gold: %d, %d, Result: %d, %d\n",
+				r, sum, max, sums[r], maxes[r]);
+			return -1;
+		}
+	}
+	printf("sparse_map/sparse_reduce Test Passed!\n");
+	return 0;
+}
+
+int test_spmv(){
+	fdense_t a;
+	std::array<float, COLS> x;
+	gen_sparse(a, 10, MAX_NNZ, 51);
+	for(int c = 0; c < COLS; ++c){
+		x[c] = (float)((c * 7) % 11 - 5) * 0.5f;
+	}
+	fcsr_t csr = to_csr<MAX_NNZ>(a);
+	// The sums are of small integers times halves, so every order of
+	// summation (dense, one lane or four) is exact
+	std::array<float, ROWS> y = hw_synth_spmv(csr, x), chain = spmv<1>(csr, x), gold = hw_synth_dense_mv(a, x);
+	for(int r = 0; r < ROWS; ++r){
+		if(y[r] != gold[r] || chain[r] != gold[r]){
+			fprintf(stderr, "Error! spmv returned the incorrect value for row %d. Gold: %f, Result: %f\n", r, gold[r], y[r]);
+			return -1;
+		}
+	}
+	printf("spmv Test Passed!\n");
+	return 0;
+}
+
+std::array<std::array<float, BENCH_COLS>, BENCH_ROWS> bench_dense;
+csr_t<float, BENCH_ROWS, BENCH_COLS, BENCH_NNZ> bench_csr;
+
+// Host time of spmv against the densified zipWith + reduce product, at
+// 2% density
+int bench(){
+	std::array<float, BENCH_COLS> x, xs;
+	gen_sparse(bench_dense, 2, BENCH_NNZ, 52);
+	for(int c = 0; c < BENCH_COLS; ++c){
+		x[c] = (float)(c % 9 - 4);
+	}
+	xs = x;
+	bench_csr = to_csr<BENCH_NNZ>(bench_dense);
+	std::array<float, BENCH_ROWS> ys, yd;
+	double ssum = 0, dsum = 0;
+	auto start = std::chrono::high_resolution_clock::now();
+	for(int i = 0; i < BENCH_ITERS; ++i){
+		x[i] += 1;
+		yd = dense_mv(bench_dense, x);
+		dsum += yd[i];
+	}
+	auto mid = std::chrono::high_resolution_clock::now();
+	for(int i = 0; i < BENCH_ITERS; ++i){
+		xs[i] += 1;
+		ys = spmv<4>(bench_csr, xs);
+		ssum += ys[i];
+	}
+	auto stop = std::chrono::high_resolution_clock::now();
+	if(ys != yd || ssum != dsum){
+		fprintf(stderr, "Error! Benchmark products did not match\n");
+		return -1;
+	}
+	double dense_t = std::chrono::duration<double>(mid - start).count() / BENCH_ITERS;
+	double sparse_t = std::chrono::duration<double>(stop - mid).count() / BENCH_ITERS;
+	printf("%dx%d, %lu nonzeros: dense zipWith+reduce %.1f us/call, spmv %.1f us/call (%.1fx)\n",
+		BENCH_ROWS, BENCH_COLS, (unsigned long)bench_csr.nnz(), dense_t * 1e6, sparse_t * 1e6, dense_t / sparse_t);
+	return 0;
+}
+
+int main(){
+	int err;
+	if((err = test_convert()) || (err = test_map_reduce()) || (err = test_spmv()) || (err = bench())){
+		return err;
+	}
+	printf("Sparse Tests passed\n");
+	return 0;	
+}
@@ -0,0 +1,184 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#include <array>
+#include <vector>
+#include "listops.hpp"
+#include "reduce.hpp"
+#include "zip.hpp"
+#include "stencil.hpp"
+#include "stream.hpp"
+#include "testops.hpp"
+#ifdef BIT_ACCURATE
+#include "ap_int.h"
+#endif
+
+#define IMAGE_WIDTH 2048
+#define IMAGE_HEIGHT 1080
+#define STREAM_WIDTH 64
+#define STREAM_HEIGHT 16
+#define KH 3
+#define KW 3
+
+class Add{
+public:
+	int operator()(int L, int R){
+#pragma HLS INLINE
+		return L + R;
+	}
+};
+
+class Mult{
+public:
+	int operator()(int L, int R){
+#pragma HLS INLINE
+		return L * R;
+	}
+};
+
+struct Dot{
+	template <typename T, std::size_t LEN>
+	T operator()(std::array<T, LEN> const& L, std::array<T, LEN> const& R){
+#pragma HLS INLINE
+		return treereduce<Add>(zipWith<Mult>(L, R));
+	}
+};
+
+// An asymmetric kernel, so that a flipped window is caught by the test
+struct Kernel{
+	std::array<std::array<int, KW>, KH> operator()(){
+#pragma HLS INLINE
+		return {{{{1, 2, -1}}, {{3, -4, 0}}, {{2, 1, 5}}}};
+	}
+};
+
+// 3x3 convolution: zipWith<Dot> multiplies and sums each row of the window
+// with the matching kernel row, and the row sums are summed with a tree
+template <class KERNEL>
+struct Conv{
+	template <typename T, std::size_t W, std::size_t H>
+	T operator()(std::array<std::array<T, W>, H> const& WIN){
+#pragma HLS INLINE
+		return treereduce<Add>(zipWith<Dot>(KERNEL()(), WIN));
+	}
+};
+
+std::array<int, IMAGE_WIDTH> hw_synth_stencil_conv(std::array<std::array<int, IMAGE_WIDTH>, KH-1>& LINES, 
+						std::array<std::array<int, KW>, KH>& WIN,
+						std::array<int, IMAGE_WIDTH> const& ROW){
+	return stencil2d<Conv<Kernel>, KH, KW, IMAGE_WIDTH>(LINES, WIN, ROW);
+}
+
+void hw_synth_stream_conv(stream<int>& IN, stream<int>& OUT){
+#pragma HLS INTERFACE axis port=IN
+#pragma HLS INTERFACE axis port=OUT
+	stencil2d<Conv<Kernel>, KH, KW, STREAM_WIDTH>(STREAM_HEIGHT, IN, OUT);
+}
+
+// Direct nested-loop convolution, anchored at the bottom-right corner of
+// the window like stencil2d
+int gold_conv(std::vector<int> const& IMG, std::size_t WIDTH, std::size_t Y, std::size_t X){
+	std::array<std::array<int, KW>, KH> k = Kernel()();
+	int acc = 0;
+	for(std::size_t r = 0; r < KH; ++r){
+		for(std::size_t c = 0; c < KW; ++c){
+			acc += k[r][c] * IMG[(Y - (KH-1) + r) * WIDTH + X - (KW-1) + c];
+		}
+	}
+	return acc;
+}
+
+int test_stencil_conv(){
+	std::vector<int> img(IMAGE_WIDTH * IMAGE_HEIGHT);
+	std::array<int, IMAGE_WIDTH> row, out;
+	std::array<std::array<int, IMAGE_WIDTH>, KH-1> lines = replicate<KH-1>(replicate<IMAGE_WIDTH>(0));
+	std::array<std::array<int, KW>, KH> win = replicate<KH>(replicate<KW>(0));
+	for(std::size_t y = 0; y < IMAGE_HEIGHT; ++y){
+		row = genarr<-1000, 1000, IMAGE_WIDTH>();
+		std::copy(row.begin(), row.end(), img.begin() + y * IMAGE_WIDTH);
+	}
+
+	for(std::size_t y = 0; y < IMAGE_HEIGHT; ++y){
+		std::copy(img.begin() + y * IMAGE_WIDTH, img.begin() + (y + 1) * IMAGE_WIDTH, row.begin());
+		out = hw_synth_stencil_conv(lines, win, row);
+		for(std::size_t x = KW-1; y >= KH-1 && x < IMAGE_WIDTH; ++x){
+			int gold = gold_conv(img, IMAGE_WIDTH, y, x);
+			if(out[x] != gold){
+				fprintf(stderr, "Error! Conv (stencil2d) returned the incorrect value at (%d, %d). Output: %d, Gold: %d\n", (int)y, (int)x, out[x], gold);
+				return -1;
+			}
+		}
+	}
+	printf("Conv (stencil2d) %dx%d Test Passed!\n", IMAGE_WIDTH, IMAGE_HEIGHT);
+	return 0;
+}
+
+int test_stream_conv(){
+	std::vector<int> img(STREAM_WIDTH * STREAM_HEIGHT);
+	stream<int> sin, sout;
+	std::array<int, STREAM_WIDTH * STREAM_HEIGHT> pix = genarr<-1000, 1000, STREAM_WIDTH * STREAM_HEIGHT>();
+	for(std::size_t i = 0; i < STREAM_WIDTH * STREAM_HEIGHT; ++i){
+		img[i] = pix[i];
+		sin.write(pix[i]);
+	}
+
+	hw_synth_stream_conv(sin, sout);
+	for(std::size_t y = 0; y < STREAM_HEIGHT; ++y){
+		for(std::size_t x = 0; x < STREAM_WIDTH; ++x){
+			int out = sout.read();
+			if(y < KH-1 || x < KW-1){
+				continue;
+			}
+			int gold = gold_conv(img, STREAM_WIDTH, y, x);
+			if(out != gold){
+				fprintf(stderr, "Error! Conv (stream stencil2d) returned the incorrect value at (%d, %d). Output: %d, Gold: %d\n", (int)y, (int)x, out, gold);
+				return -1;
+			}
+		}
+	}
+	printf("Conv (stream stencil2d) Test Passed!\n");
+	return 0;
+}
+
+int main(){
+	int err;
+	if((err = test_stencil_conv())){
+		return err;
+	}
+	if((err = test_stream_conv())){
+		return err;
+	}
+	printf("Stencil Tests passed\n");
+	return 0;	
+}
@@ -0,0 +1,174 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#include <array>
+#include <chrono>
+#include <thread>
+#include "stream.hpp"
+#include "testops.hpp"
+#ifdef BIT_ACCURATE
+#include "ap_int.h"
+#endif
+
+#define MULTCONST 35
+#define LOG_LIST_LENGTH 6
+#define LIST_LENGTH (1<<LOG_LIST_LENGTH)
+#define LOG_STREAM_LENGTH 22
+#define STREAM_LENGTH (1<<LOG_STREAM_LENGTH)
+#define STREAM_DEPTH 1024
+
+template <int VAL>
+class MultBy{
+public:
+	int operator()(int const& IN){
+#pragma HLS INLINE
+		return VAL*IN;
+	}
+};
+
+template <class FTOR, typename T, std::size_t DEPTH>
+void stream_map(std::size_t LEN, stream<T, DEPTH>& IN, stream<T, DEPTH>& OUT){
+stream_map_loop:
+	for(std::size_t i = 0; i < LEN; ++i){
+#pragma HLS PIPELINE
+		OUT.write(FTOR()(IN.read()));
+	}
+}
+
+void hw_synth_stream_map(stream<int>& IN, stream<int>& OUT){
+#pragma HLS INTERFACE axis port=IN
+#pragma HLS INTERFACE axis port=OUT
+	stream_map<MultBy<MULTCONST>>(LIST_LENGTH, IN, OUT);
+}
+
+std::array<int, LIST_LENGTH> hw_synth_for_map(std::array<int, LIST_LENGTH> IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS PIPELINE
+	std::array<int, LIST_LENGTH> out;
+#pragma HLS ARRAY_PARTITION complete VARIABLE=out._M_instance
+	for(int i = 0; i < LIST_LENGTH; ++i){
+#pragma HLS UNROLL
+		out[i] = MultBy<MULTCONST>()(IN[i]);
+	}
+	return out;
+}
+
+int test_map(){
+	std::array<int, LIST_LENGTH> in = genarr<-1000, 1000, LIST_LENGTH>();
+	std::array<int, LIST_LENGTH> gold = hw_synth_for_map(in);
+	stream<int> sin, sout;
+	int out;
+
+	// The streams are far shallower than the list: like hls::stream, the
+	// C-sim stream holds everything written before the kernel runs
+	for(int i = 0; i < LIST_LENGTH; ++i){
+		sin << in[i];
+	}
+	if(sin.size() != LIST_LENGTH){
+		fprintf(stderr, "Error! Stream held %zu of %d writes\n", sin.size(), LIST_LENGTH);
+		return -1;
+	}
+	if(!sin.full()){
+		fprintf(stderr, "Error! Stream was not full after %d writes\n", LIST_LENGTH);
+		return -1;
+	}
+	if(sin.write_nb(0)){
+		fprintf(stderr, "Error! Non-blocking write to a full stream succeeded\n");
+		return -1;
+	}
+
+	hw_synth_stream_map(sin, sout);
+	if(!sin.empty()){
+		fprintf(stderr, "Error! Input stream was not drained\n");
+		return -1;
+	}
+
+	for(int i = 0; i < LIST_LENGTH; ++i){
+		sout >> out;
+		if(out != gold[i]){
+			fprintf(stderr, "Error! Map (stream) returned the incorrect value at index %d. Output: %d, Gold: %d\n", i, out, gold[i]);
+			return -1;
+		}
+	}
+	if(sout.read_nb(out)){
+		fprintf(stderr, "Error! Non-blocking read from an empty stream succeeded\n");
+		return -1;
+	}
+	printf("Map (stream) Test Passed!\n");
+	return 0;
+}
+
+void producer(stream<int, STREAM_DEPTH>& OUT){
+	for(int i = 0; i < STREAM_LENGTH; ++i){
+		OUT.write(i);
+	}
+}
+
+int test_threaded_map(){
+	stream<int, STREAM_DEPTH> sin, sout;
+	int out, errors = 0;
+
+	auto start = std::chrono::high_resolution_clock::now();
+	std::thread p(producer, std::ref(sin));
+	std::thread k(stream_map<MultBy<MULTCONST>, int, STREAM_DEPTH>, 
+		STREAM_LENGTH, std::ref(sin), std::ref(sout));
+	for(int i = 0; i < STREAM_LENGTH; ++i){
+		sout >> out;
+		errors += (out != MULTCONST*i);
+	}
+	p.join();
+	k.join();
+	auto stop = std::chrono::high_resolution_clock::now();
+
+	if(errors){
+		fprintf(stderr, "Error! Map (threaded stream) returned %d incorrect values\n", errors);
+		return -1;
+	}
+	double secs = std::chrono::duration<double>(stop - start).count();
+	printf("Map (threaded stream) Test Passed! %d items in %f s (%.1f Mitems/s)\n", 
+		STREAM_LENGTH, secs, STREAM_LENGTH / secs / 1e6);
+	return 0;
+}
+
+int main(){
+	int err;
+	if((err = test_map())){
+		return err;
+	}
+	if((err = test_threaded_map())){
+		return err;
+	}
+	printf("Stream Tests passed\n");
+	return 0;	
+}
@@ -0,0 +1,227 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#include <array>
+#include "listops.hpp"
+#include "reduce.hpp"
+#include "zip.hpp"
+#include "window.hpp"
+#include "stream.hpp"
+#include "testops.hpp"
+#ifdef BIT_ACCURATE
+#include "ap_int.h"
+#endif
+
+#define LOG_LIST_LENGTH 6
+#define LIST_LENGTH (1<<LOG_LIST_LENGTH)
+#define NUM_FRAMES 4
+#define NUM_TAPS 64
+#define TREE_DEPTH 3
+
+class Add{
+public:
+	int operator()(int L, int R){
+#pragma HLS INLINE
+		return L + R;
+	}
+};
+
+class Mult{
+public:
+	int operator()(int L, int R){
+#pragma HLS INLINE
+		return L * R;
+	}
+};
+
+// A fixed, non-symmetric set of filter coefficients
+struct Taps{
+	std::array<int, NUM_TAPS> operator()(){
+#pragma HLS INLINE
+		std::array<int, NUM_TAPS> taps;
+#pragma HLS ARRAY_PARTITION complete VARIABLE=taps._M_instance
+		for(int k = 0; k < NUM_TAPS; ++k){
+#pragma HLS UNROLL
+			taps[k] = (k * 7) % 13 - 6;
+		}
+		return taps;
+	}
+};
+
+// Direct-form FIR: multiply the window by the taps, then sum the products
+// with an adder tree of depth LEV (chains below the tree)
+template <class COEFFS, std::size_t LEV>
+struct Fir{
+	template <typename T, std::size_t W>
+	T operator()(std::array<T, W> const& WIN){
+#pragma HLS INLINE
+		return treereduce<Add, LEV>(zipWith<Mult>(COEFFS()(), WIN));
+	}
+};
+
+// Transposed-form FIR: the register holds partial sums instead of
+// inputs, so every output is one multiply and one add away from the input
+template <class COEFFS, typename T, std::size_t W, std::size_t LEN>
+std::array<T, LEN> transposed_fir(std::array<T, W>& ACC, std::array<T, LEN> const& IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=ACC._M_instance
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS INLINE
+	std::array<T, LEN> out;
+#pragma HLS ARRAY_PARTITION complete VARIABLE=out._M_instance
+	for(std::size_t i = 0; i < LEN; ++i){
+#pragma HLS UNROLL
+		auto prods = zipWith<Mult>(COEFFS()(), replicate<W>(IN[i]));
+		ACC = zipWith<Add>(shiftl(ACC, T(0)), prods);
+		out[i] = head(ACC);
+	}
+	return out;
+}
+
+std::array<int, LIST_LENGTH> hw_synth_fir(std::array<int, NUM_TAPS>& REG, std::array<int, LIST_LENGTH> IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=REG._M_instance
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS PIPELINE
+	return window<Fir<Taps, TREE_DEPTH>, NUM_TAPS>(REG, IN);
+}
+
+std::array<int, LIST_LENGTH> hw_synth_fir_chain(std::array<int, NUM_TAPS>& REG, std::array<int, LIST_LENGTH> IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=REG._M_instance
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS PIPELINE
+	return window<Fir<Taps, 0>, NUM_TAPS>(REG, IN);
+}
+
+std::array<int, LIST_LENGTH> hw_synth_transposed_fir(std::array<int, NUM_TAPS>& ACC, std::array<int, LIST_LENGTH> IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=ACC._M_instance
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS PIPELINE
+	return transposed_fir<Taps>(ACC, IN);
+}
+
+void hw_synth_stream_fir(std::array<int, NUM_TAPS>& REG, stream<int>& IN, stream<int>& OUT){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=REG._M_instance
+#pragma HLS INTERFACE axis port=IN
+#pragma HLS INTERFACE axis port=OUT
+	window<Fir<Taps, clog2(NUM_TAPS)>>(LIST_LENGTH, REG, IN, OUT);
+}
+
+std::array<int, LIST_LENGTH> hw_synth_for_fir(std::array<int, NUM_TAPS>& REG, std::array<int, LIST_LENGTH> IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=REG._M_instance
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS PIPELINE
+	std::array<int, NUM_TAPS> taps = Taps()();
+	std::array<int, LIST_LENGTH> out;
+#pragma HLS ARRAY_PARTITION complete VARIABLE=out._M_instance
+	for(int i = 0; i < LIST_LENGTH; ++i){
+#pragma HLS UNROLL
+		for(int k = NUM_TAPS - 1; k > 0; --k){
+#pragma HLS UNROLL
+			REG[k] = REG[k-1];
+		}
+		REG[0] = IN[i];
+		int acc = 0;
+		for(int k = 0; k < NUM_TAPS; ++k){
+#pragma HLS UNROLL
+			acc += taps[k] * REG[k];
+		}
+		out[i] = acc;
+	}
+	return out;
+}
+
+int test_treereduce(){
+	std::array<int, 13> in = genarr<-1000, 1000, 13>();
+	int gold = 0;
+	for(int i = 0; i < 13; ++i){
+		gold += in[i];
+	}
+	if(treereduce<Add>(in) != gold || treereduce<Add, 0>(in) != gold ||
+		treereduce<Add, 2>(in) != gold){
+		fprintf(stderr, "Error! Treereduce returned the incorrect value\n");
+		return -1;
+	}
+	printf("Treereduce Test Passed!\n");
+	return 0;
+}
+
+int test_fir(){
+	std::array<int, LIST_LENGTH * NUM_FRAMES> in = genarr<-1000, 1000, LIST_LENGTH * NUM_FRAMES>();
+	std::array<int, LIST_LENGTH * NUM_FRAMES> gold;
+	std::array<int, NUM_TAPS> taps = Taps()();
+	for(int n = 0; n < LIST_LENGTH * NUM_FRAMES; ++n){
+		gold[n] = 0;
+		for(int k = 0; k < NUM_TAPS && k <= n; ++k){
+			gold[n] += taps[k] * in[n - k];
+		}
+	}
+
+	std::array<int, NUM_TAPS> rfir = replicate<NUM_TAPS>(0), rchain = rfir, 
+		racc = rfir, rstream = rfir, rfor = rfir;
+	stream<int> sin, sout;
+	for(int f = 0; f < NUM_FRAMES; ++f){
+		std::array<int, LIST_LENGTH> frame;
+		for(int i = 0; i < LIST_LENGTH; ++i){
+			frame[i] = in[f * LIST_LENGTH + i];
+			sin.write(frame[i]);
+		}
+		auto ofir = hw_synth_fir(rfir, frame);
+		auto ochain = hw_synth_fir_chain(rchain, frame);
+		auto oacc = hw_synth_transposed_fir(racc, frame);
+		auto ofor = hw_synth_for_fir(rfor, frame);
+		hw_synth_stream_fir(rstream, sin, sout);
+		for(int i = 0; i < LIST_LENGTH; ++i){
+			int g = gold[f * LIST_LENGTH + i];
+			int ostream = sout.read();
+			if(ofir[i] != g || ochain[i] != g || oacc[i] != g || ofor[i] != g || ostream != g){
+				fprintf(stderr, "Error! FIR returned the incorrect value at index %d. Gold: %d, Tree: %d, Chain: %d, Transposed: %d, Stream: %d, For: %d\n", 
+					f * LIST_LENGTH + i, g, ofir[i], ochain[i], oacc[i], ostream, ofor[i]);
+				return -1;
+			}
+		}
+	}
+	printf("FIR (window, transposed, stream, for) Test Passed!\n");
+	return 0;
+}
+
+int main(){
+	int err;
+	if((err = test_treereduce())){
+		return err;
+	}
+	if((err = test_fir())){
+		return err;
+	}
+	printf("Window Tests passed\n");
+	return 0;	
+}
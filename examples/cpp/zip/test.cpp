@@ -58,6 +58,14 @@ std::array<int, LIST_LENGTH> hw_synth_zipwith(std::array<int, LIST_LENGTH> &L, s
 	return zipWith<Add>(L, R);
 }
 
+void hw_synth_zipwith_into(std::array<int, LIST_LENGTH> &L, std::array<int, LIST_LENGTH> R, std::array<int, LIST_LENGTH>& OUT){
+#pragma HLS ARRAY_PARTITION variable=R complete
+#pragma HLS ARRAY_PARTITION variable=L complete
+#pragma HLS ARRAY_PARTITION variable=OUT complete
+#pragma HLS PIPELINE
+	zipWith_into<Add>(L, R, OUT);
+}
+
 std::array<std::pair<int, int>, LIST_LENGTH> hw_synth_zip(std::array<int, LIST_LENGTH> &L, std::array<int, LIST_LENGTH> R){
 #pragma HLS ARRAY_PARTITION variable=R complete
 #pragma HLS ARRAY_PARTITION variable=L complete
@@ -115,6 +123,13 @@ int test_zipwith(){
 	}
 
 	printf("ZipWith Add Test Passed!\n");
+
+	hw_synth_zipwith_into(left, right, left);
+	if(left != output){
+		printf("Error! ZipWith (into) output did not match zipWith\n");
+		return -1;
+	}
+	printf("ZipWith Add (into) Test Passed!\n");
 	return 0;
 }
 int test_zip_add(){
@@ -153,6 +168,57 @@ int test_unzip(){
 	return 0;
 }
 
+// Fused multiply-add over three lists, in one pass with zipWithN
+class Fma{
+public:
+	int operator()(int A, int B, int C){
+#pragma HLS INLINE
+		return A * B + C;
+	}
+};
+
+std::array<int, LIST_LENGTH> hw_synth_zipwithn_fma(std::array<int, LIST_LENGTH> A, std::array<int, LIST_LENGTH> B, std::array<int, LIST_LENGTH> C){
+#pragma HLS ARRAY_PARTITION variable=A complete
+#pragma HLS ARRAY_PARTITION variable=B complete
+#pragma HLS ARRAY_PARTITION variable=C complete
+#pragma HLS PIPELINE
+	return zipWithN<Fma>(A, B, C);
+}
+
+int test_zipn(){
+	std::array<int, LIST_LENGTH> a = genarr<-1000, 1000, LIST_LENGTH>();
+	std::array<int, LIST_LENGTH> b = genarr<-1000, 1000, LIST_LENGTH>();
+	std::array<int, LIST_LENGTH> c = genarr<-1000, 1000, LIST_LENGTH>();
+	std::array<float, LIST_LENGTH> d;
+	for(int i = 0; i < LIST_LENGTH; ++i){
+		d[i] = 0.5f * i;
+	}
+
+	std::array<int, LIST_LENGTH> fma = hw_synth_zipwithn_fma(a, b, c);
+	for(int i = 0; i < LIST_LENGTH; ++i){
+		if(fma[i] != a[i] * b[i] + c[i]){
+			printf("Error! ZipWithN (fma) output incorrect at index %d\n", i);
+			return -1;
+		}
+	}
+	printf("ZipWithN FMA Test Passed!\n");
+
+	auto zipped = zipN(a, b, d);
+	for(int i = 0; i < LIST_LENGTH; ++i){
+		if(zipped[i] != std::make_tuple(a[i], b[i], d[i])){
+			printf("Error! ZipN output incorrect at index %d\n", i);
+			return -1;
+		}
+	}
+	auto unzipped = unzipN(zipped);
+	if(std::get<0>(unzipped) != a || std::get<1>(unzipped) != b || std::get<2>(unzipped) != d){
+		printf("Error! UnzipN did not invert zipN\n");
+		return -1;
+	}
+	printf("ZipN/UnzipN Test Passed!\n");
+	return 0;
+}
+
 int main(){
 	int err;
 	if((err = test_zip_add())){
@@ -167,6 +233,9 @@ int main(){
 	if((err = test_unzip())){
 		return err;
 	}
+	if((err = test_zipn())){
+		return err;
+	}
 	printf("Zip Tests passed\n");
 	return 0;	
 }
@@ -0,0 +1,160 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#ifndef __ACCUMULATE_HPP
+#define __ACCUMULATE_HPP
+#include <array>
+#include "reduce.hpp"
+#include "traits.hpp"
+
+// Accumulation policies for reduce, rreduce, treereduce and divconq. Each
+// policy is a functor adapter, so it is chosen where FTOR is chosen:
+//
+//	reduce<Widen<Add, double>>(0.0, IN);		// float data, double sum
+//	reduce<NeumaierAdd>(neumaier_t<float>(), IN);	// compensated chain
+//	divconq<NeumaierAdd>(IN);			// compensated tree
+//	pairwise<Add>(IN);				// fixed tree shape
+//
+// Like the functors in the examples, the adapters also accept the
+// single-element arrays that divconq passes at its leaves.
+
+// Widen converts both operands to TACC before applying FTOR, so narrow
+// storage types (e.g. float, int16_t) can be summed in a wide accumulator
+// (e.g. double, ap_int<48>).
+template <class FTOR, typename TACC>
+struct Widen{
+	template <typename TL, typename TR>
+	auto operator()(TL const& L, TR const& R) -> decltype(FTOR()(TACC(L), TACC(R))){
+#pragma HLS INLINE
+		return FTOR()(TACC(L), TACC(R));
+	}
+
+	template <typename T>
+	auto operator()(std::array<T, 1> const& L, std::array<T, 1> const& R) -> decltype(FTOR()(TACC(L[0]), TACC(R[0]))){
+#pragma HLS INLINE
+		return FTOR()(TACC(L[0]), TACC(R[0]));
+	}
+};
+
+template <class FTOR, typename TACC>
+struct is_associative<Widen<FTOR, TACC> > : is_associative<FTOR>{};
+
+template <class FTOR, typename TACC>
+struct is_commutative<Widen<FTOR, TACC> > : is_commutative<FTOR>{};
+
+template <class FTOR, typename TACC>
+struct identity<Widen<FTOR, TACC> > : identity<FTOR>{};
+
+// A running sum and the rounding error lost from it so far. Converting
+// back to T adds the compensation into the sum.
+template <typename T>
+struct neumaier_t{
+	T sum, c;
+	operator T() const{
+#pragma HLS INLINE
+		return sum + c;
+	}
+};
+
+// Neumaier's improvement of Kahan summation: the rounding error of every
+// addition is recovered exactly and accumulated separately, so the error
+// of the sum does not grow with the length of the list. It costs three
+// extra adds and a compare per element. Compensated float addition is not
+// associative, so NeumaierAdd is not marked associative: reduce keeps the
+// sequential compensated chain, and divconq builds the tree explicitly.
+struct NeumaierAdd{
+	template <typename T>
+	neumaier_t<T> operator()(neumaier_t<T> const& L, T const& R){
+#pragma HLS INLINE
+		T s = L.sum + R;
+		T al = L.sum < 0 ? -L.sum : L.sum;
+		T ar = R < 0 ? -R : R;
+		T err = (al >= ar) ? (L.sum - s) + R : (R - s) + L.sum;
+		return {s, L.c + err};
+	}
+
+	template <typename T>
+	neumaier_t<T> operator()(T const& L, neumaier_t<T> const& R){
+#pragma HLS INLINE
+		return this->operator()(R, L);
+	}
+
+	template <typename T>
+	neumaier_t<T> operator()(T const& L, T const& R){
+#pragma HLS INLINE
+		return this->operator()(neumaier_t<T>{L, T()}, R);
+	}
+
+	template <typename T>
+	neumaier_t<T> operator()(neumaier_t<T> const& L, neumaier_t<T> const& R){
+#pragma HLS INLINE
+		neumaier_t<T> s = this->operator()(L, R.sum);
+		return {s.sum, s.c + R.c};
+	}
+
+	template <typename T>
+	neumaier_t<T> operator()(std::array<T, 1> const& L, std::array<T, 1> const& R){
+#pragma HLS INLINE
+		return this->operator()(L[0], R[0]);
+	}
+};
+
+template <>
+struct identity<NeumaierAdd>{
+	template <typename T>
+	static constexpr T value(){
+		return T();
+	}
+};
+
+// Pairwise summation: a full treereduce, whose shape depends only on LEN.
+// Error grows with log2(LEN) rather than LEN, and the result is
+// bit-identical to divconq for power-of-two lengths.
+template <class FTOR, typename TA, std::size_t LEN>
+auto pairwise(std::array<TA, LEN> const& IN) -> decltype(treereduce<FTOR>(IN)){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS INLINE
+	return treereduce<FTOR>(IN);
+}
+
+template <class FTOR>
+struct Pairwise{
+	template <typename TA, std::size_t LEN>
+	auto operator()(std::array<TA, LEN> const& IN) -> decltype(pairwise<FTOR>(IN)){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS INLINE
+		return pairwise<FTOR>(IN);
+	}
+};
+#endif // __ACCUMULATE_HPP
@@ -0,0 +1,181 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#ifndef __BENES_HPP
+#define __BENES_HPP
+#include <array>
+#include <vector>
+#include "listops.hpp"
+#include "constops.hpp"
+
+// A Benes network routes any permutation of LEN = 2^n inputs through
+// 2n-1 columns of LEN/2 2x2 switches, instead of the LEN x LEN
+// multiplexers of a crossbar. The network is built recursively: a column
+// of input switches, an upper and a lower Benes network of half the size,
+// and a column of output switches.
+//
+// The switch settings (the configuration) are an ordinary input to
+// route(), so the permutation can change at run time. Configurations are
+// computed on the host by benes<T, LEN>::configure, with the looping
+// algorithm. A configuration for LEN inputs is laid out as:
+//
+//	[input switches (LEN/2)][upper network][lower network][output switches (LEN/2)]
+//
+// where a set bit means the switch is crossed.
+constexpr std::size_t benes_switches(std::size_t LEN){
+	return LEN <= 2 ? 1 : LEN + 2 * benes_switches(LEN / 2);
+}
+
+template <std::size_t LEV>
+struct _bnHelp{
+	template <typename T>
+	static std::array<T, (1 << LEV)> route(std::array<T, (1 << LEV)> const& IN,
+					std::array<bool, benes_switches(1 << LEV)> const& CFG){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS ARRAY_PARTITION complete VARIABLE=CFG._M_instance
+#pragma HLS INLINE
+		static const std::size_t HALF = 1 << (LEV - 1);
+		std::array<T, HALF> upper, lower;
+#pragma HLS ARRAY_PARTITION complete VARIABLE=upper._M_instance
+#pragma HLS ARRAY_PARTITION complete VARIABLE=lower._M_instance
+		std::array<T, 2*HALF> temp;
+#pragma HLS ARRAY_PARTITION complete VARIABLE=temp._M_instance
+		auto cin = splitat<HALF>(CFG);
+		auto cup = splitat<benes_switches(HALF)>(cin.second);
+		auto clow = splitat<benes_switches(HALF)>(cup.second);
+	HOPS_LABEL(benes_input_loop)
+		for(std::size_t i = 0; i < HALF; ++i){
+#pragma HLS UNROLL
+			upper[i] = cin.first[i] ? IN[2*i + 1] : IN[2*i];
+			lower[i] = cin.first[i] ? IN[2*i] : IN[2*i + 1];
+		}
+		upper = _bnHelp<LEV-1>::route(upper, cup.first);
+		lower = _bnHelp<LEV-1>::route(lower, clow.first);
+	HOPS_LABEL(benes_output_loop)
+		for(std::size_t i = 0; i < HALF; ++i){
+#pragma HLS UNROLL
+			temp[2*i] = clow.second[i] ? lower[i] : upper[i];
+			temp[2*i + 1] = clow.second[i] ? upper[i] : lower[i];
+		}
+		return temp;
+	}
+};
+
+template <>
+struct _bnHelp<1>{
+	template <typename T>
+	static std::array<T, 2> route(std::array<T, 2> const& IN, std::array<bool, 1> const& CFG){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS INLINE
+		return CFG[0] ? std::array<T, 2>{{IN[1], IN[0]}} : IN;
+	}
+};
+
+// Routes IN through a Benes network with switch settings CFG
+template <typename T, std::size_t LEN>
+std::array<T, LEN> route(std::array<T, LEN> const& IN, std::array<bool, benes_switches(LEN)> const& CFG){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS ARRAY_PARTITION complete VARIABLE=CFG._M_instance
+#pragma HLS INLINE
+	static_assert((LEN & (LEN - 1)) == 0 && LEN >= 2, "Benes networks need a power-of-two length");
+	return _bnHelp<hlog2(LEN)>::route(IN, CFG);
+}
+
+struct Route{
+	template <typename T, std::size_t LEN>
+	std::array<T, LEN> operator()(std::array<T, LEN> const& IN, std::array<bool, benes_switches(LEN)> const& CFG){
+#pragma HLS INLINE
+		return route(IN, CFG);
+	}
+};
+
+// Host-side looping algorithm. DST[i] is the output that input i is
+// routed to; the settings are written starting at CFG.
+inline void _benes_configure(std::vector<std::size_t> const& DST, bool * CFG){
+	std::size_t n = DST.size(), half = n / 2;
+	if(n == 2){
+		CFG[0] = DST[0] == 1;
+		return;
+	}
+	std::vector<std::size_t> inv(n), udst(half), ldst(half);
+	std::vector<int> side(n, -1);
+	for(std::size_t i = 0; i < n; ++i){
+		inv[DST[i]] = i;
+	}
+	// Inputs that share an input switch go to different halves, and so do
+	// the inputs feeding the two outputs of an output switch. Start each
+	// loop by sending an unassigned input to the upper half, and follow
+	// the constraints until the loop closes.
+	for(std::size_t s = 0; s < half; ++s){
+		std::size_t i = 2*s;
+		while(side[i] == -1){
+			side[i] = 0;
+			side[i ^ 1] = 1;
+			i = inv[DST[i ^ 1] ^ 1];
+		}
+	}
+	for(std::size_t i = 0; i < n; ++i){
+		(side[i] ? ldst : udst)[i / 2] = DST[i] / 2;
+	}
+	for(std::size_t s = 0; s < half; ++s){
+		CFG[s] = side[2*s] == 1;
+		CFG[half + 2*benes_switches(half) + s] = side[inv[2*s]] == 1;
+	}
+	_benes_configure(udst, CFG + half);
+	_benes_configure(ldst, CFG + half + benes_switches(half));
+}
+
+template <typename T, std::size_t LEN>
+struct benes{
+	static const std::size_t SWITCHES = benes_switches(LEN);
+	typedef std::array<bool, SWITCHES> config_t;
+
+	// Computes the switch settings so that route(IN, CFG)[i] == IN[SRC[i]].
+	// SRC must be a permutation of 0 ... LEN-1.
+	static config_t configure(std::array<std::size_t, LEN> const& SRC){
+		config_t cfg;
+		std::vector<std::size_t> dst(LEN);
+		for(std::size_t i = 0; i < LEN; ++i){
+			dst[SRC[i]] = i;
+		}
+		_benes_configure(dst, cfg.data());
+		return cfg;
+	}
+
+	static std::array<T, LEN> route(std::array<T, LEN> const& IN, config_t const& CFG){
+#pragma HLS INLINE
+		return ::route(IN, CFG);
+	}
+};
+#endif // __BENES_HPP
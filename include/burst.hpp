@@ -0,0 +1,192 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#ifndef __BURST_HPP
+#define __BURST_HPP
+#include <cstddef>
+#include <array>
+#include <tuple>
+#include <utility>
+#include "constops.hpp"
+
+// Adapters between external memory (DRAM, through an AXI master port)
+// and the std::array frames the higher-order functions work on:
+//
+// - load_burst<LEN>(MEM): reads LEN elements starting at MEM.
+// - store_burst(MEM, IN): writes IN starting at MEM.
+// - pingpong<KERNEL, LEN>(FRAMES, IN, OUT): applies KERNEL (a functor
+//   from std::array<TI, LEN> to std::array<TO, OLEN>) to FRAMES
+//   consecutive frames of IN, writing consecutive frames of OUT. The
+//   load, the kernel and the store are DATAFLOW processes, and frames
+//   are double buffered between them, so loading frame i+1, computing
+//   frame i and storing frame i-1 overlap: the throughput is set by the
+//   slowest of the three, not their sum.
+//
+// Each load and store is a single pipelined loop over consecutive
+// addresses, which HLS turns into AXI bursts; the port is declared on the
+// top-level function, e.g.
+//
+//   #pragma HLS INTERFACE m_axi port=IN offset=slave depth=... 
+//
+// In C-sim, burst_counters() counts the bursts and beats that the
+// transfers would take, where a burst is at most BURST_MAX_BEATS beats
+// and does not cross a 4 KB boundary (as in AXI4). An m_axi port is as
+// wide as its element type, so a beat carries one element (or
+// BURST_BUS_BYTES of an element wider than the bus): narrow elements
+// should be packed into bus words (pack.hpp) to use the full width. Its
+// cycles() adds BURST_LATENCY cycles per burst to one cycle per beat;
+// pingpong_cycles models the overlapped schedule.
+#ifndef BURST_BUS_BYTES
+#define BURST_BUS_BYTES 64
+#endif
+#ifndef BURST_MAX_BEATS
+#define BURST_MAX_BEATS 256
+#endif
+#ifndef BURST_LATENCY
+#define BURST_LATENCY 100
+#endif
+
+#ifndef __SYNTHESIS__
+struct burst_stats{
+	std::size_t bursts, beats;
+
+	burst_stats() : bursts(0), beats(0){}
+
+	void reset(){
+		bursts = beats = 0;
+	}
+
+	std::size_t cycles() const{
+		return bursts * BURST_LATENCY + beats;
+	}
+};
+
+inline burst_stats& burst_counters(){
+	static burst_stats stats;
+	return stats;
+}
+
+// Splits the transfer of BYTES bytes at ADDR, in elements of ELEM bytes,
+// into bursts
+inline void _burstCount(std::size_t ADDR, std::size_t BYTES, std::size_t ELEM){
+	const std::size_t PAGE = 4096;
+	const std::size_t BEAT = (ELEM < BURST_BUS_BYTES) ? ELEM : BURST_BUS_BYTES;
+	const std::size_t MAX = BURST_MAX_BEATS * BEAT;
+	burst_stats& stats = burst_counters();
+	while(BYTES > 0){
+		std::size_t len = PAGE - ADDR % PAGE;
+		len = (len < MAX) ? len : MAX;
+		len = (len < BYTES) ? len : BYTES;
+		std::size_t first = ADDR / BEAT;
+		std::size_t last = (ADDR + len - 1) / BEAT;
+		stats.bursts += 1;
+		stats.beats += last - first + 1;
+		ADDR += len;
+		BYTES -= len;
+	}
+}
+
+// Cycles of FRAMES frames through pingpong, where each frame takes LOAD,
+// COMPUTE and STORE cycles: the pipeline fills and drains in two extra
+// steps, and each step is as long as its slowest stage
+inline std::size_t pingpong_cycles(std::size_t FRAMES, std::size_t LOAD, std::size_t COMPUTE, std::size_t STORE){
+	std::size_t step = (LOAD > COMPUTE) ? LOAD : COMPUTE;
+	step = (step > STORE) ? step : STORE;
+	return (FRAMES + 2) * step;
+}
+#endif
+
+template <std::size_t LEN, typename T>
+std::array<T, LEN> load_burst(const T* MEM){
+#pragma HLS INLINE
+	std::array<T, LEN> out;
+#ifndef __SYNTHESIS__
+	_burstCount((std::size_t)MEM, LEN * sizeof(T), sizeof(T));
+#endif
+	for(std::size_t i = 0; i < LEN; ++i){
+#pragma HLS PIPELINE II=1
+		out[i] = MEM[i];
+	}
+	return out;
+}
+
+template <typename T, std::size_t LEN>
+void store_burst(T* MEM, std::array<T, LEN> const& IN){
+#pragma HLS INLINE
+#ifndef __SYNTHESIS__
+	_burstCount((std::size_t)MEM, LEN * sizeof(T), sizeof(T));
+#endif
+	for(std::size_t i = 0; i < LEN; ++i){
+#pragma HLS PIPELINE II=1
+		MEM[i] = IN[i];
+	}
+}
+
+// The processes of pingpong. Each is a function of its own, not inlined,
+// so that DATAFLOW can run them concurrently on different frames.
+template <std::size_t LEN, typename TI>
+void _pingpongLoad(const TI* IN, std::array<TI, LEN>& FRAME){
+	FRAME = load_burst<LEN>(IN);
+}
+
+template <class KERNEL, std::size_t LEN, typename TI, typename TO, std::size_t OLEN>
+void _pingpongCompute(std::array<TI, LEN> const& IN, std::array<TO, OLEN>& OUT){
+	OUT = KERNEL()(IN);
+}
+
+template <typename TO, std::size_t OLEN>
+void _pingpongStore(TO* OUT, std::array<TO, OLEN> const& FRAME){
+	store_burst(OUT, FRAME);
+}
+
+// Each iteration of the frame loop is a dataflow region of the load,
+// compute and store processes. The frames passed between them become
+// ping-pong buffers (PIPOs), so the processes of consecutive iterations
+// overlap: while frame i is computed, frame i+1 is loaded into the other
+// input buffer, and frame i-1 is stored from the other output buffer.
+template <class KERNEL, std::size_t LEN, typename TI, typename TO>
+void pingpong(std::size_t FRAMES, const TI* IN, TO* OUT){
+	typedef decltype(KERNEL()(std::declval<std::array<TI, LEN> >())) out_t;
+	static const std::size_t OLEN = std::tuple_size<out_t>::value;
+HOPS_LABEL(pingpong_frames)
+	for(std::size_t f = 0; f < FRAMES; ++f){
+#pragma HLS DATAFLOW
+		std::array<TI, LEN> in;
+		std::array<TO, OLEN> out;
+		_pingpongLoad<LEN>(IN + f * LEN, in);
+		_pingpongCompute<KERNEL>(in, out);
+		_pingpongStore(OUT + f * OLEN, out);
+	}
+}
+#endif // __BURST_HPP
@@ -0,0 +1,217 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#ifndef __CONSTMULT_HPP
+#define __CONSTMULT_HPP
+#include <cstddef>
+#include <array>
+#include <type_traits>
+#include "constops.hpp"
+#include "zip.hpp"
+#include "reduce.hpp"
+
+// Multiplication by compile-time constants with shifts and adds instead
+// of a multiplier (a DSP in hardware). VAL is recoded in canonical signed
+// digit (CSD) form, where every digit is -1, 0 or 1 and no two adjacent
+// digits are nonzero, so a B-bit constant has at most B/2 + 1 nonzero
+// digits (35 = 100101 becomes 10-1001, 3 terms either way; 15 = 1111
+// becomes 1000-1, 2 terms instead of 4). The positive and negative terms
+// are summed with balanced adder trees and subtracted once at the end:
+//
+// - ConstMult<VAL>: X * VAL, e.g. map<ConstMult<35>>(IN). ADDERS is the
+//   number of adders/subtractors in the tree, and tree(X) builds it. C-sim
+//   runs the same tree as synthesis, so that it checks the recoding, even
+//   though on the host a multiply is usually faster.
+// - ConstMults<VALS...>: multiple constants. On a scalar X it returns
+//   the array {X * VALS...}, e.g. the products of one sample and all the
+//   taps of a transposed-form FIR. Constants that differ by a power of
+//   two share the tree of their odd part (6X is (3X) << 1). Only whole
+//   trees are shared: partial sums common to constants with different
+//   odd parts (X + 4X in both 5X and 21X) are not factored out, so
+//   ADDERS is an upper bound on what a multiple-constant multiplication
+//   algorithm that searches for shared terms would use. On an array it
+//   multiplies elementwise, in place of zipWith<Mult>(COEFFS, WIN) in a
+//   direct-form FIR.
+//
+// T should be an integer or fixed-point type: integers are shifted as
+// unsigned values, so negative values and wraparound behave like X * VAL
+// does; other types are multiplied by 2^S, which is wiring for
+// fixed-point types. For floating-point types a plain multiply is both
+// cheaper and exact.
+
+// CSD digit I of VAL (-1, 0 or 1). The low digit is chosen so that the
+// rest of VAL, (VAL - digit)/2, is even whenever the digit is nonzero.
+constexpr int _csdLow(long long VAL){
+	return (VAL & 1) ? 2 - (int)(VAL & 3) : 0;
+}
+
+constexpr int _csdDigit(long long VAL, std::size_t I){
+	return (I == 0) ? _csdLow(VAL) : _csdDigit((VAL - _csdLow(VAL)) / 2, I - 1);
+}
+
+// Number of digits of VAL equal to SIGN
+constexpr std::size_t _csdCount(long long VAL, int SIGN, std::size_t I = 0){
+	return (I == 64) ? 0 : (_csdDigit(VAL, I) == SIGN) + _csdCount(VAL, SIGN, I + 1);
+}
+
+// Position of the K-th digit of VAL equal to SIGN
+constexpr std::size_t _csdPos(long long VAL, int SIGN, std::size_t K, std::size_t I = 0){
+	return (_csdDigit(VAL, I) != SIGN) ? _csdPos(VAL, SIGN, K, I + 1) :
+		(K == 0) ? I : _csdPos(VAL, SIGN, K - 1, I + 1);
+}
+
+// X * 2^S
+template <std::size_t S, typename T>
+typename std::enable_if<std::is_integral<T>::value, T>::type _csdShift(T const& X){
+#pragma HLS INLINE
+	return (T)((typename std::make_unsigned<T>::type)X << S);
+}
+
+template <std::size_t S, typename T>
+typename std::enable_if<!std::is_integral<T>::value, T>::type _csdShift(T const& X){
+#pragma HLS INLINE
+	return X * (T)(1ULL << S);
+}
+
+struct _csdAdd{
+	template <typename T>
+	T operator()(T const& L, T const& R){
+#pragma HLS INLINE
+		return L + R;
+	}
+};
+
+// The shifted copies of X, one per digit of VAL equal to SIGN
+template <long long VAL, int SIGN, typename T, std::size_t... K>
+std::array<T, sizeof...(K)> _csdTerms(T const& X, _idxseq<K...>){
+#pragma HLS INLINE
+	return {{_csdShift<_csdPos(VAL, SIGN, K)>(X)...}};
+}
+
+template <typename T>
+T _csdSum(std::array<T, 0> const&){
+#pragma HLS INLINE
+	return T(0);
+}
+
+template <typename T, std::size_t N>
+T _csdSum(std::array<T, N> const& TERMS){
+#pragma HLS INLINE
+	return treereduce<_csdAdd, clog2(N)>(TERMS);
+}
+
+template <long long VAL>
+struct ConstMult{
+	static constexpr std::size_t POS = _csdCount(VAL, 1);
+	static constexpr std::size_t NEG = _csdCount(VAL, -1);
+	static constexpr std::size_t ADDERS = (POS + NEG == 0) ? 0 :
+		POS + NEG - (POS != 0);
+
+	// The shift-add tree
+	template <typename T>
+	static T tree(T const& X){
+#pragma HLS INLINE
+		T p = _csdSum(_csdTerms<VAL, 1>(X, typename _mkidxseq<POS>::type()));
+		if(NEG == 0)
+			return p;
+		T n = _csdSum(_csdTerms<VAL, -1>(X, typename _mkidxseq<NEG>::type()));
+		return p - n;
+	}
+
+	template <typename T>
+	T operator()(T const& X){
+#pragma HLS INLINE
+		return tree(X);
+	}
+};
+
+// VAL / 2^_csdTwos(VAL) is odd (or zero)
+constexpr std::size_t _csdTwos(long long VAL){
+	return (VAL == 0 || (VAL & 1)) ? 0 : 1 + _csdTwos(VAL / 2);
+}
+
+constexpr long long _csdOdd(long long VAL){
+	return (VAL == 0 || (VAL & 1)) ? VAL : _csdOdd(VAL / 2);
+}
+
+// True if one of REST has the odd part ODD
+constexpr bool _csdShared(long long){
+	return false;
+}
+
+template <typename... REST>
+constexpr bool _csdShared(long long ODD, long long VAL, REST... R){
+	return _csdOdd(VAL) == ODD || _csdShared(ODD, R...);
+}
+
+// Adders for the distinct odd parts of VALS
+template <long long... VALS>
+struct _mcmAdders{
+	static constexpr std::size_t value = 0;
+};
+
+template <long long VAL, long long... VALS>
+struct _mcmAdders<VAL, VALS...>{
+	static constexpr std::size_t value = _mcmAdders<VALS...>::value +
+		(_csdShared(_csdOdd(VAL), VALS...) ? 0 : ConstMult<_csdOdd(VAL)>::ADDERS);
+};
+
+template <long long... VALS>
+struct ConstMults{
+	static constexpr std::size_t ADDERS = _mcmAdders<VALS...>::value;
+
+	// Every constant is a shift of the tree for its odd part; trees for
+	// repeated odd parts are identical expressions, and are merged by
+	// common subexpression elimination (in HLS and on the host)
+	template <typename T>
+	std::array<T, sizeof...(VALS)> operator()(T const& X){
+#pragma HLS INLINE
+		return {{_csdShift<_csdTwos(VALS)>(ConstMult<_csdOdd(VALS)>()(X))...}};
+	}
+
+	template <typename T>
+	std::array<T, sizeof...(VALS)> operator()(std::array<T, sizeof...(VALS)> const& X){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=X._M_instance
+#pragma HLS INLINE
+		return _elementwise(X, typename _mkidxseq<sizeof...(VALS)>::type());
+	}
+
+private:
+	template <typename T, std::size_t... IDX>
+	static std::array<T, sizeof...(VALS)> _elementwise(std::array<T, sizeof...(VALS)> const& X, _idxseq<IDX...>){
+#pragma HLS INLINE
+		return {{ConstMult<VALS>()(X[IDX])...}};
+	}
+};
+#endif // __CONSTMULT_HPP
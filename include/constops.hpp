@@ -35,6 +35,34 @@
 #ifndef __CONSTOPS_HPP
 #define __CONSTOPS_HPP
 #include <utility>
+
+// The list operations and HOFs are constexpr when compiled as C++17 or
+// later, which allows loops that assign to std::array elements in constant
+// expressions. Under C++11 (and Vivado HLS) they are ordinary functions.
+#if __cplusplus >= 201703L
+#define CONSTEXPR17 constexpr
+#else
+#define CONSTEXPR17
+#endif
+
+// Loop labels name the loops in the synthesis reports and are the targets
+// of directives in Tcl scripts. C-sim does not use them (and g++ warns
+// about them), so HOPS_LABEL only emits the label under synthesis.
+// Labels are not allowed in constexpr functions before C++23, so
+// CONSTEXPR17_LABEL is for loops in CONSTEXPR17 functions: it also drops
+// the label when those functions are constexpr.
+#ifdef __SYNTHESIS__
+#define HOPS_LABEL(L) L:
+#else
+#define HOPS_LABEL(L)
+#endif
+
+#if __cplusplus >= 201703L
+#define CONSTEXPR17_LABEL(L)
+#else
+#define CONSTEXPR17_LABEL(L) HOPS_LABEL(L)
+#endif
+
 constexpr std::size_t hlog2(std::size_t n)
 {
 	return ((n <= 2) ? 1 : 1 + hlog2(n / 2));
@@ -39,10 +39,11 @@
 #include "listops.hpp"
 #include "constops.hpp"
 #include "hof.hpp"
+#include "policy.hpp"
 template <class FTOR, std::size_t LEV>
 struct _dcHelp{
 	template<typename TA, std::size_t FHLEN>
-	static auto divconq(std::array<TA, FHLEN> const& IN) -> 
+	static CONSTEXPR17 auto divconq(std::array<TA, FHLEN> const& IN) -> 
 		decltype(FTOR()(_dcHelp<FTOR, LEV-1>::divconq(std::array<TA, (FHLEN)/2>()),
 				_dcHelp<FTOR, LEV-1>::divconq(std::array<TA, (FHLEN)/2>()))) {
 #pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
@@ -59,7 +60,7 @@ struct _dcHelp{
 template <class FTOR>
 struct _dcHelp<FTOR, 1>{
 	template <typename TA>
-	static auto divconq(std::array<TA, 2> const& IN) -> decltype(unpair<FTOR>(splitat<1>(IN))){
+	static CONSTEXPR17 auto divconq(std::array<TA, 2> const& IN) -> decltype(unpair<FTOR>(splitat<1>(IN))){
 #pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
 #pragma HLS INLINE
 		return unpair<FTOR>(splitat<1>(IN));
@@ -69,21 +70,107 @@ struct _dcHelp<FTOR, 1>{
 };
 
 template <class FTOR, typename TA, std::size_t LEN>
-auto divconq(std::array<TA, LEN> const& IN) -> decltype(_dcHelp<FTOR, clog2(LEN)>::divconq(IN)){
+CONSTEXPR17 auto divconq(std::array<TA, LEN> const& IN) -> decltype(_dcHelp<FTOR, clog2(LEN)>::divconq(IN)){
 #pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
 #pragma HLS INLINE
 #pragma HLS PIPELINE
 	return _dcHelp<FTOR, clog2(LEN)>::divconq(IN);
 }
 
+template <class POLICY>
+struct _divconqPolicy;
+
+template <>
+struct _divconqPolicy<unrolled>{
+	template <class FTOR, typename TA, std::size_t LEN>
+	static CONSTEXPR17 auto divconq(std::array<TA, LEN> const& IN) -> decltype(::divconq<FTOR>(IN)){
+#pragma HLS INLINE
+		return ::divconq<FTOR>(IN);
+	}
+};
+
+// The folded divconq computes the tree one level at a time, in place, with
+// F operators per level. The leaves are passed to FTOR as elements, not as
+// std::array<TA, 1>, so FTOR must map (TA, TA) to TA.
+template <std::size_t F>
+struct _divconqPolicy<folded<F> >{
+	template <class FTOR, typename TA, std::size_t LEN>
+	static TA divconq(std::array<TA, LEN> const& IN){
+#pragma HLS INLINE
+		static_assert(LEN == (1ULL << clog2(LEN)), "LEN must be a power of two");
+		std::array<TA, LEN> temp = IN;
+#pragma HLS ARRAY_PARTITION cyclic factor=F VARIABLE=temp._M_instance
+	HOPS_LABEL(divconq_level_loop)
+		for(std::size_t n = LEN / 2; n > 0; n /= 2){
+		HOPS_LABEL(divconq_folded_loop)
+			for(std::size_t i = 0; i < n; ++i){
+#pragma HLS PIPELINE
+#pragma HLS UNROLL factor=F
+				temp[i] = FTOR()(temp[2 * i], temp[2 * i + 1]);
+			}
+		}
+		return temp[0];
+	}
+};
+
+template <>
+struct _divconqPolicy<streaming> : _divconqPolicy<folded<1> >{};
+
+#ifndef __SYNTHESIS__
+// The host_par divconq evaluates the top LEV levels of the tree with one
+// thread per branch, and the remaining subtrees with divconq, so the
+// result (and its type) is the same as the unrolled divconq.
+template <class FTOR, std::size_t LEV>
+struct _dcPar{
+	template <typename TA, std::size_t LEN>
+	static auto divconq(std::array<TA, LEN> const& IN) ->
+		decltype(FTOR()(_dcPar<FTOR, LEV-1>::divconq(std::array<TA, LEN/2>()),
+				_dcPar<FTOR, LEV-1>::divconq(std::array<TA, LEN/2>()))){
+		auto p = splitat<LEN/2>(IN);
+		decltype(_dcPar<FTOR, LEV-1>::divconq(p.first)) l;
+		std::thread t([&](){
+				l = _dcPar<FTOR, LEV-1>::divconq(p.first);
+			});
+		auto r = _dcPar<FTOR, LEV-1>::divconq(p.second);
+		t.join();
+		return FTOR()(l, r);
+	}
+};
+
 template <class FTOR>
+struct _dcPar<FTOR, 0>{
+	template <typename TA, std::size_t LEN>
+	static auto divconq(std::array<TA, LEN> const& IN) -> decltype(::divconq<FTOR>(IN)){
+		return ::divconq<FTOR>(IN);
+	}
+};
+
+template <>
+struct _divconqPolicy<host_par>{
+	template <class FTOR, typename TA, std::size_t LEN>
+	static auto divconq(std::array<TA, LEN> const& IN) ->
+		decltype(_dcPar<FTOR, (clog2(LEN) > 3 ? 3 : clog2(LEN) - 1)>::divconq(IN)){
+		return _dcPar<FTOR, (clog2(LEN) > 3 ? 3 : clog2(LEN) - 1)>::divconq(IN);
+	}
+};
+#endif
+
+// divconq<FTOR, POLICY>(IN) computes the same result as divconq<FTOR>(IN),
+// using the execution policy POLICY (see policy.hpp)
+template <class FTOR, class POLICY, typename TA, std::size_t LEN>
+CONSTEXPR17 auto divconq(std::array<TA, LEN> const& IN) -> decltype(_divconqPolicy<POLICY>::template divconq<FTOR>(IN)){
+#pragma HLS INLINE
+	return _divconqPolicy<POLICY>::template divconq<FTOR>(IN);
+}
+
+template <class FTOR, class POLICY = unrolled>
 struct Divconq{
 	template <typename TA, std::size_t LEN>
-	auto operator()(std::array<TA, LEN> const& IN) -> decltype(divconq(IN)){
+	CONSTEXPR17 auto operator()(std::array<TA, LEN> const& IN) -> decltype(divconq<FTOR, POLICY>(IN)){
 #pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
 #pragma HLS INLINE
 #pragma HLS PIPELINE
-		return divconq<FTOR>(IN);
+		return divconq<FTOR, POLICY>(IN);
 	}
 };
 #endif
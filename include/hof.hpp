@@ -35,17 +35,18 @@
 #ifndef __HOF_HPP
 #define __HOF_HPP
 #include <utility>
+#include "constops.hpp"
 template <class FTOR>
 struct Flip{
 	template <class TL, class TR>
-	auto operator()(TL L, TR R) -> decltype(FTOR()(R, L)){
+	CONSTEXPR17 auto operator()(TL&& L, TR&& R) -> decltype(FTOR()(std::forward<TR>(R), std::forward<TL>(L))){
 #pragma HLS INLINE
-		return FTOR()(R, L);
+		return FTOR()(std::forward<TR>(R), std::forward<TL>(L));
 	}
 };
 
 template<class FTOR, typename TL, typename TR>
-auto unpair(std::pair<TL, TR> IN) -> decltype(FTOR()(IN.first, IN.second)){
+CONSTEXPR17 auto unpair(std::pair<TL, TR> const& IN) -> decltype(FTOR()(IN.first, IN.second)){
 #pragma HLS INLINE
 	return FTOR()(IN.first, IN.second);
 }
@@ -53,7 +54,7 @@ auto unpair(std::pair<TL, TR> IN) -> decltype(FTOR()(IN.first, IN.second)){
 template<class FTOR>
 struct Unpair{
 	template<typename TL, typename TR>
-	auto operator()(std::pair<TL, TR> IN) -> decltype(FTOR()(IN.first, IN.second)){
+	CONSTEXPR17 auto operator()(std::pair<TL, TR> const& IN) -> decltype(FTOR()(IN.first, IN.second)){
 		return FTOR()(IN.first, IN.second);
 	}
 };
@@ -61,8 +62,8 @@ struct Unpair{
 template<class FTORA, class FTORB>
 struct Compose{
 	template<typename... TS>
-	auto operator()(TS... INS) -> decltype(FTORA()(FTORB()(INS...))){
-		return FTORA()(FTORB()(INS...));
+	CONSTEXPR17 auto operator()(TS&&... INS) -> decltype(FTORA()(FTORB()(std::forward<TS>(INS)...))){
+		return FTORA()(FTORB()(std::forward<TS>(INS)...));
 	}
 };
 #endif
@@ -39,11 +39,11 @@
 #include "constops.hpp"
 
 template<std::size_t STOP, std::size_t START = 0, std::size_t STEP = 1>
-auto range() -> std::array<std::size_t, (STOP-START)/STEP>{
+CONSTEXPR17 auto range() -> std::array<std::size_t, (STOP-START)/STEP>{
 #pragma HLS INLINE
-	std::array<std::size_t, (STOP-START)/STEP> temp;
+	std::array<std::size_t, (STOP-START)/STEP> temp{};
 #pragma HLS ARRAY_PARTITION complete VARIABLE=temp._M_instance
-range_loop: 
+CONSTEXPR17_LABEL(range_loop)
 	for(std::size_t v = START, idx = 0; v < STOP; v +=STEP, ++idx){
 #pragma HLS UNROLL
 		temp[idx] = v;
@@ -53,20 +53,20 @@ range_loop:
 
 struct Range{
 	template<int STOP, int START = 0, int STEP = 1>
-	auto operator()() -> decltype(range<STOP, START, STEP>()){
+	CONSTEXPR17 auto operator()() -> decltype(range<STOP, START, STEP>()){
 #pragma HLS INLINE
 		return range<STOP, START, STEP>();
 	}
 };
 
 template<typename TA, std::size_t LEN>
-auto cons(TA const& H, const std::array<TA, LEN>& T) -> std::array<TA, LEN+1>{
+CONSTEXPR17 auto cons(TA const& H, const std::array<TA, LEN>& T) -> std::array<TA, LEN+1>{
 #pragma HLS ARRAY_PARTITION complete VARIABLE=T._M_instance
 #pragma HLS INLINE
-	std::array<TA, LEN+1> temp;
+	std::array<TA, LEN+1> temp{};
 #pragma HLS ARRAY_PARTITION complete VARIABLE=temp._M_instance
 	temp[0] = H;
-concat_loop:
+CONSTEXPR17_LABEL(concat_loop)
 	for(int idx = 0; idx < LEN; ++idx){
 #pragma HLS UNROLL
 		temp[idx+1] = T[idx];
@@ -75,12 +75,12 @@ concat_loop:
 };
 
 template<typename TA, std::size_t LEN>
-auto reverse(const std::array<TA, LEN>& L) -> std::array<TA, LEN>{
-	std::array<TA, LEN> res;
+CONSTEXPR17 auto reverse(const std::array<TA, LEN>& L) -> std::array<TA, LEN>{
+	std::array<TA, LEN> res{};
 #pragma HLS INLINE
 #pragma HLS ARRAY_PARTITION complete VARIABLE=L._M_instance
 #pragma HLS ARRAY_PARTITION complete VARIABLE=res._M_instance
-reverse_loop:
+CONSTEXPR17_LABEL(reverse_loop)
 	for(int idx = 0; idx < LEN; ++idx){
 #pragma HLS UNROLL
 		res[idx] = L[LEN-(idx+1)];
@@ -90,20 +90,19 @@ reverse_loop:
 
 struct Cons{
 	template<typename TA, std::size_t LEN>
-	auto operator()(TA const& H, const std::array<TA, LEN>& T) -> decltype(cons(H, T)) {
+	CONSTEXPR17 auto operator()(TA const& H, const std::array<TA, LEN>& T) -> decltype(cons(H, T)) {
 #pragma HLS INLINE
 #pragma HLS ARRAY_PARTITION complete VARIABLE=T._M_instance
 		return cons(H, T);
 	}
 };
 
-// How do we make this constexpr? Should we?
 template<typename TA, std::size_t LEN>
-auto rcons(const std::array<TA, LEN>& T, TA const& H) -> std::array<TA, LEN+1>{
+CONSTEXPR17 auto rcons(const std::array<TA, LEN>& T, TA const& H) -> std::array<TA, LEN+1>{
 #pragma HLS INLINE
-	std::array<TA, LEN+1> temp;
+	std::array<TA, LEN+1> temp{};
 #pragma HLS ARRAY_PARTITION complete VARIABLE=temp._M_instance
-rcons_loop:
+CONSTEXPR17_LABEL(rcons_loop)
 	for(int idx = 0; idx < LEN; ++idx){
 #pragma HLS UNROLL
 		temp[idx] = T[idx];
@@ -114,26 +113,25 @@ rcons_loop:
 
 struct Rcons{
 	template<typename TA, std::size_t LEN>
-	auto operator()(const std::array<TA, LEN>& T, TA const& H) -> decltype(rcons(T, H)) {
+	CONSTEXPR17 auto operator()(const std::array<TA, LEN>& T, TA const& H) -> decltype(rcons(T, H)) {
 #pragma HLS INLINE
 		return rcons(T, H);
 	}
 };
 
-// How do we make this constexpr? Should we?
 template<typename TA, std::size_t LLEN, std::size_t RLEN>
-auto merge(const std::array<TA, LLEN> LIN, const std::array<TA, RLEN> RIN) -> std::array<TA, LLEN+RLEN>{
+CONSTEXPR17 auto merge(const std::array<TA, LLEN>& LIN, const std::array<TA, RLEN>& RIN) -> std::array<TA, LLEN+RLEN>{
 #pragma HLS ARRAY_PARTITION complete VARIABLE=LIN._M_instance
 #pragma HLS ARRAY_PARTITION complete VARIABLE=RIN._M_instance
 #pragma HLS INLINE
-	std::array<TA, LLEN+RLEN> temp;
+	std::array<TA, LLEN+RLEN> temp{};
 #pragma HLS ARRAY_PARTITION complete VARIABLE=temp._M_instance
-merge_left_loop:
+CONSTEXPR17_LABEL(merge_left_loop)
 	for(int idx = 0; idx < LLEN; ++idx){
 #pragma HLS UNROLL
 		temp[idx] = LIN[idx];
 	}
-merge_right_loop:
+CONSTEXPR17_LABEL(merge_right_loop)
 	for(int idx=0; idx < RLEN; ++idx){
 #pragma HLS UNROLL
 		temp[idx + LLEN] = RIN[idx];
@@ -142,7 +140,7 @@ merge_right_loop:
 }
 
 template<typename TA, std::size_t LLEN, std::size_t RLEN>
-auto operator+(const std::array<TA, LLEN> LIN, const std::array<TA, RLEN> RIN) -> std::array<TA, LLEN+RLEN>{
+CONSTEXPR17 auto operator+(const std::array<TA, LLEN>& LIN, const std::array<TA, RLEN>& RIN) -> std::array<TA, LLEN+RLEN>{
 #pragma HLS ARRAY_PARTITION complete VARIABLE=LIN._M_instance
 #pragma HLS ARRAY_PARTITION complete VARIABLE=RIN._M_instance
 #pragma HLS INLINE
@@ -151,7 +149,7 @@ auto operator+(const std::array<TA, LLEN> LIN, const std::array<TA, RLEN> RIN) -
 
 struct Merge{
 	template<typename TA, std::size_t LLEN, std::size_t RLEN>
-	auto operator()(const std::array<TA, LLEN>& LIN, const std::array<TA, RLEN>& RIN) -> decltype(merge(LIN, RIN)){
+	CONSTEXPR17 auto operator()(const std::array<TA, LLEN>& LIN, const std::array<TA, RLEN>& RIN) -> decltype(merge(LIN, RIN)){
 #pragma HLS ARRAY_PARTITION complete VARIABLE=LIN._M_instance
 #pragma HLS ARRAY_PARTITION complete VARIABLE=RIN._M_instance
 #pragma HLS INLINE
@@ -159,13 +157,12 @@ struct Merge{
 	}
 };
 
-// How do we make this constexpr? Should we?
 template<std::size_t LEN, typename T>
-auto replicate(const T& v) -> std::array<T, LEN>{
+CONSTEXPR17 auto replicate(const T& v) -> std::array<T, LEN>{
 #pragma HLS INLINE
-	std::array<T, LEN> temp;
+	std::array<T, LEN> temp{};
 #pragma HLS ARRAY_PARTITION complete VARIABLE=temp._M_instance
-replicate_loop:
+CONSTEXPR17_LABEL(replicate_loop)
 	for(int idx = 0; idx < LEN; ++idx){
 #pragma HLS UNROLL
 		temp[idx] = v;
@@ -175,28 +172,27 @@ replicate_loop:
 
 struct Replicate{
 	template<typename T, std::size_t LEN>
-	auto operator()(const T& v) -> decltype(replicate<T, LEN>(v)){
+	CONSTEXPR17 auto operator()(const T& v) -> decltype(replicate<T, LEN>(v)){
 #pragma HLS INLINE
 		return replicate<T, LEN>(v);
 	}
 };
 
-// How do we make this constexpr? Should we?
 template<std::size_t IDX, typename TA, std::size_t LEN>
-auto splitat(const std::array<TA, LEN>& IN) -> std::pair<std::array<TA, (IDX > LEN)? LEN : IDX>, std::array<TA, (IDX > LEN)? 0 : LEN - IDX > >{
+CONSTEXPR17 auto splitat(const std::array<TA, LEN>& IN) -> std::pair<std::array<TA, (IDX > LEN)? LEN : IDX>, std::array<TA, (IDX > LEN)? 0 : LEN - IDX > >{
 #pragma HLS INLINE
-	static const std::size_t llen = (IDX > LEN)? LEN : IDX;
-	static const std::size_t rlen = (IDX > LEN)? 0 : LEN - IDX;
-	std::array<TA, llen> l;
+	const std::size_t llen = (IDX > LEN)? LEN : IDX;
+	const std::size_t rlen = (IDX > LEN)? 0 : LEN - IDX;
+	std::array<TA, llen> l{};
 #pragma HLS ARRAY_PARTITION complete VARIABLE=l._M_instance
-	std::array<TA, rlen> r;
+	std::array<TA, rlen> r{};
 #pragma HLS ARRAY_PARTITION complete VARIABLE=r._M_instance
-	split_left_loop:
+	CONSTEXPR17_LABEL(split_left_loop)
 	for(int idx = 0; idx < llen; ++idx){
 #pragma HLS UNROLL
 		l[idx] = IN[idx];
 	}
-	split_right_loop:
+	CONSTEXPR17_LABEL(split_right_loop)
 	for(int ridx = llen, idx=0; idx < rlen; ++ridx, ++idx){
 #pragma HLS UNROLL
 		r[idx] = IN[ridx];
@@ -206,33 +202,32 @@ auto splitat(const std::array<TA, LEN>& IN) -> std::pair<std::array<TA, (IDX > L
 
 struct Splitat{
 	template<std::size_t IDX, typename TA, std::size_t LEN>
-	auto operator()(const std::array<TA, LEN>& IN) -> decltype(splitat<IDX, TA, LEN>(IN)){
+	CONSTEXPR17 auto operator()(const std::array<TA, LEN>& IN) -> decltype(splitat<IDX, TA, LEN>(IN)){
 #pragma HLS INLINE
 		return splitat<IDX, TA, LEN>(IN);
 	}
 };
 
 template<typename TA, std::size_t LEN>
-TA head(const std::array<TA, LEN>& t){
+CONSTEXPR17 TA head(const std::array<TA, LEN>& t){
 #pragma HLS INLINE
 	return t[0];
 }
 
 struct Head{
 	template<typename TA, std::size_t LEN>
-	TA operator()(const std::array<TA, LEN>& t){
+	CONSTEXPR17 TA operator()(const std::array<TA, LEN>& t){
 #pragma HLS INLINE
 		return head(t);
 	}
 };
 
-// How do we make this constexpr?
 template<typename TA, std::size_t LEN>
-auto tail(std::array<TA, LEN> const & L) -> std::array<TA, LEN-1>{
+CONSTEXPR17 auto tail(std::array<TA, LEN> const & L) -> std::array<TA, LEN-1>{
 #pragma HLS INLINE
-	std::array<TA, LEN-1> temp;
+	std::array<TA, LEN-1> temp{};
 #pragma HLS ARRAY_PARTITION complete VARIABLE=temp._M_instance
-tail_loop:
+CONSTEXPR17_LABEL(tail_loop)
 	for(int idx = 0; idx < LEN-1; ++idx){
 #pragma HLS UNROLL
 		temp[idx] = L[idx+1];
@@ -242,35 +237,35 @@ tail_loop:
 
 struct Tail{
 	template<typename TA, std::size_t LEN>
-	auto operator()(std::array<TA, LEN> const& L) -> decltype(tail(L)){
+	CONSTEXPR17 auto operator()(std::array<TA, LEN> const& L) -> decltype(tail(L)){
 #pragma HLS INLINE
 		return tail(L);
 	}
 };
 
 template <typename TA, std::size_t LEN> 
-std::array<TA, LEN> shiftr (TA const& H, std::array<TA, LEN> const& T){
+CONSTEXPR17 std::array<TA, LEN> shiftr (TA const& H, std::array<TA, LEN> const& T){
 #pragma HLS INLINE
 	return cons(H, splitat<LEN-1>(T).first);
 }
 
 struct Shiftr{
 	template <typename TA, std::size_t LEN> 
-	std::array<TA, LEN> operator()(TA const& H, std::array<TA, LEN> const& T){
+	CONSTEXPR17 std::array<TA, LEN> operator()(TA const& H, std::array<TA, LEN> const& T){
 #pragma HLS INLINE
 		return shiftr(H, T);
 	}
 };
 
 template <typename TA, std::size_t LEN>
-std::array<TA, LEN> shiftl(std::array<TA, LEN> const& T, TA const& H){
+CONSTEXPR17 std::array<TA, LEN> shiftl(std::array<TA, LEN> const& T, TA const& H){
 #pragma HLS INLINE
 	return rcons(tail(T), H);
 }
 
 struct Shiftl{
 	template <typename TA, std::size_t LEN> 
-	std::array<TA, LEN> operator()(std::array<TA, LEN> const& T, TA const& H){
+	CONSTEXPR17 std::array<TA, LEN> operator()(std::array<TA, LEN> const& T, TA const& H){
 #pragma HLS INLINE
 		return shiftl(T, H);
 	}
@@ -278,7 +273,7 @@ struct Shiftl{
 
 struct Array{
 	template<typename T>
-	std::array<T, 2> operator()(T L, T R){
+	CONSTEXPR17 std::array<T, 2> operator()(T L, T R){
 #pragma HLS INLINE
 		return {L, R};
 	}
@@ -292,8 +287,8 @@ struct Array{
 };
 
 template<std::size_t LEN, typename T>
-auto convert(const T L[LEN]) -> std::array<T, LEN>{
-	std::array<T, LEN> temp;
+CONSTEXPR17 auto convert(const T L[LEN]) -> std::array<T, LEN>{
+	std::array<T, LEN> temp{};
 #pragma HLS ARRAY_PARTITION complete VARIABLE=temp._M_instance
 	for(int idx = 0; idx < LEN; ++idx){
 #pragma HLS UNROLL
@@ -35,11 +35,13 @@
 #ifndef __MAP_HPP
 #define __MAP_HPP
 #include <array>
+#include "constops.hpp"
+#include "policy.hpp"
 template <class FTOR, typename TI, std::size_t LEN> 
-auto map(std::array<TI, LEN> IN) -> decltype(std::array<decltype(FTOR()(IN[0])), LEN>()){
+CONSTEXPR17 auto map(std::array<TI, LEN> const& IN) -> decltype(std::array<decltype(FTOR()(IN[0])), LEN>()){
 #pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
 #pragma HLS INLINE
-	std::array<decltype(FTOR()(IN[0])), LEN> temp;
+	std::array<decltype(FTOR()(IN[0])), LEN> temp{};
 #pragma HLS ARRAY_PARTITION complete VARIABLE=temp._M_instance
 	for(std::size_t i = 0; i < LEN; ++i){
 #pragma HLS UNROLL
@@ -48,13 +50,80 @@ auto map(std::array<TI, LEN> IN) -> decltype(std::array<decltype(FTOR()(IN[0])),
 	return temp;
 }
 
-template <class FTOR>
+// map_inplace<FTOR>(IO) overwrites each element of IO with FTOR applied to
+// it. It computes the same result as IO = map<FTOR>(IO), without a
+// temporary list, so FTOR must return a type that converts to T.
+template <class FTOR, typename T, std::size_t LEN>
+CONSTEXPR17 void map_inplace(std::array<T, LEN>& IO){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IO._M_instance
+#pragma HLS INLINE
+	for(std::size_t i = 0; i < LEN; ++i){
+#pragma HLS UNROLL
+		IO[i] = FTOR()(IO[i]);
+	}
+}
+
+template <class POLICY>
+struct _mapPolicy;
+
+template <>
+struct _mapPolicy<unrolled>{
+	template <class FTOR, typename TI, std::size_t LEN>
+	static CONSTEXPR17 auto map(std::array<TI, LEN> const& IN) -> decltype(::map<FTOR>(IN)){
+#pragma HLS INLINE
+		return ::map<FTOR>(IN);
+	}
+};
+
+template <std::size_t F>
+struct _mapPolicy<folded<F> >{
+	template <class FTOR, typename TI, std::size_t LEN>
+	static auto map(std::array<TI, LEN> const& IN) -> std::array<decltype(FTOR()(IN[0])), LEN>{
+#pragma HLS ARRAY_PARTITION cyclic factor=F VARIABLE=IN._M_instance
+#pragma HLS INLINE
+		std::array<decltype(FTOR()(IN[0])), LEN> temp;
+#pragma HLS ARRAY_PARTITION cyclic factor=F VARIABLE=temp._M_instance
+		for(std::size_t i = 0; i < LEN; ++i){
+#pragma HLS PIPELINE
+#pragma HLS UNROLL factor=F
+			temp[i] = FTOR()(IN[i]);
+		}
+		return temp;
+	}
+};
+
+template <>
+struct _mapPolicy<streaming> : _mapPolicy<folded<1> >{};
+
+#ifndef __SYNTHESIS__
+template <>
+struct _mapPolicy<host_par>{
+	template <class FTOR, typename TI, std::size_t LEN>
+	static auto map(std::array<TI, LEN> const& IN) -> std::array<decltype(FTOR()(IN[0])), LEN>{
+		std::array<decltype(FTOR()(IN[0])), LEN> temp;
+		_host_parallel_for(LEN, [&](std::size_t i){
+				temp[i] = FTOR()(IN[i]);
+			});
+		return temp;
+	}
+};
+#endif
+
+// map<FTOR, POLICY>(IN) computes the same result as map<FTOR>(IN), using
+// the execution policy POLICY (see policy.hpp)
+template <class FTOR, class POLICY, typename TI, std::size_t LEN>
+CONSTEXPR17 auto map(std::array<TI, LEN> const& IN) -> decltype(_mapPolicy<POLICY>::template map<FTOR>(IN)){
+#pragma HLS INLINE
+	return _mapPolicy<POLICY>::template map<FTOR>(IN);
+}
+
+template <class FTOR, class POLICY = unrolled>
 struct Map{
 	template <typename TI, std::size_t LEN> 
-	auto operator()(std::array<TI, LEN> const& IN) -> decltype(map<FTOR>(IN)) {
+	CONSTEXPR17 auto operator()(std::array<TI, LEN> const& IN) -> decltype(map<FTOR, POLICY>(IN)) {
 #pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
 #pragma HLS INLINE
-		return map<FTOR>(IN);
+		return map<FTOR, POLICY>(IN);
 	}
 };
 #endif //__MAP_HPP
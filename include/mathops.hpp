@@ -0,0 +1,464 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#ifndef __MATHOPS_HPP
+#define __MATHOPS_HPP
+#include <cstddef>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#if __cplusplus >= 202002L
+#include <bit>
+#endif
+#include "constops.hpp"
+
+// Functors for sin, cos, atan2, magnitude, exp and (reciprocal) square
+// root, built from adds, shifts and a few multiplies instead of the
+// floating-point cores HLS generates for <cmath>. They can be used like
+// any other functor, e.g. map<Cordic<Sin>>(ANGLES) or
+// zipWith<Cordic<Atan2>>(YS, XS). T can be float, double or a fixed-point
+// type; iteration counts and polynomial degrees are template arguments,
+// and set the precision:
+//
+// - Cordic<MODE, ITERS>: ITERS CORDIC iterations (about one bit each),
+//   each 3 add/subtracts and 2 shifts. MODE is Sin, Cos or SinCos
+//   (rotation; the angle in radians), or Atan2 or Hypot (vectoring, on
+//   Y and X). Cordic<SinCos>(-A) is the twiddle (cos, sin) of FFTOP.
+// - PolyExp<DEG>: exp as 2^K * P(R), where P is the degree-DEG Taylor
+//   polynomial (DEG multiply-adds) and |R| <= ln(2)/2.
+// - RSqrt<ITERS>: 1/sqrt as a linear estimate refined by ITERS Newton
+//   steps (each 3 multiplies and a subtract, doubling the bits);
+//   Sqrt<ITERS> is X * RSqrt<ITERS>(X).
+//
+// Range reduction is done in T. The quadrant of Cordic and the power of
+// two of PolyExp are a constant multiply, a rounding to an integer and a
+// multiply-subtract; the power of four of RSqrt is read from the exponent
+// field of a floating-point argument, and found by a search of shifts
+// and compares (a leading-zero count) for a fixed-point one. _scalb
+// (X * 2^E) is an exponent add for floating-point types and a shift for
+// fixed-point types.
+struct Sin{};
+struct Cos{};
+struct SinCos{};
+struct Atan2{};
+struct Hypot{};
+
+// atan(2^-i)
+constexpr double _cordicAtan[48] = {
+	0.78539816339744828, 0.46364760900080609, 0.24497866312686414, 0.12435499454676144,
+	0.06241880999595735, 0.031239833430268277, 0.015623728620476831, 0.0078123410601011111,
+	0.0039062301319669718, 0.0019531225164788188, 0.00097656218955931946, 0.00048828121119489829,
+	0.00024414062014936177, 0.00012207031189367021, 6.1035156174208773e-05, 3.0517578115526096e-05,
+	1.5258789061315762e-05, 7.62939453110197e-06, 3.8146972656064961e-06, 1.907348632810187e-06,
+	9.5367431640596084e-07, 4.7683715820308884e-07, 2.3841857910155797e-07, 1.1920928955078068e-07,
+	5.9604644775390552e-08, 2.9802322387695303e-08, 1.4901161193847655e-08, 7.4505805969238281e-09,
+	3.7252902984619141e-09, 1.862645149230957e-09, 9.3132257461547852e-10, 4.6566128730773926e-10,
+	2.3283064365386963e-10, 1.1641532182693481e-10, 5.8207660913467407e-11, 2.9103830456733704e-11,
+	1.4551915228366852e-11, 7.2759576141834259e-12, 3.637978807091713e-12, 1.8189894035458565e-12,
+	9.0949470177292824e-13, 4.5474735088646412e-13, 2.2737367544323206e-13, 1.1368683772161603e-13,
+	5.6843418860808015e-14, 2.8421709430404007e-14, 1.4210854715202004e-14, 7.1054273576010019e-15
+};
+
+// The gain of the first N iterations is 1/_cordicGain[N]
+constexpr double _cordicGain[49] = {
+	1, 0.70710678118654746, 0.63245553203367577, 0.61357199107789628,
+	0.60883391251775243, 0.60764825625616814, 0.60735177014129593, 0.60727764409352603,
+	0.60725911229889273, 0.60725447933256238, 0.60725332108987518, 0.60725303152913435,
+	0.60725295913894484, 0.60725294104139715, 0.60725293651701018, 0.60725293538591341,
+	0.60725293510313927, 0.60725293503244571, 0.60725293501477229, 0.60725293501035393,
+	0.60725293500924937, 0.60725293500897326, 0.6072529350089042, 0.607252935008887,
+	0.60725293500888267, 0.60725293500888156, 0.60725293500888133, 0.60725293500888133,
+	0.60725293500888133, 0.60725293500888133, 0.60725293500888133, 0.60725293500888133,
+	0.60725293500888133, 0.60725293500888133, 0.60725293500888133, 0.60725293500888133,
+	0.60725293500888133, 0.60725293500888133, 0.60725293500888133, 0.60725293500888133,
+	0.60725293500888133, 0.60725293500888133, 0.60725293500888133, 0.60725293500888133,
+	0.60725293500888133, 0.60725293500888133, 0.60725293500888133, 0.60725293500888133,
+	0.60725293500888133
+};
+
+constexpr double _factorial(std::size_t N){
+	return (N <= 1) ? 1.0 : N * _factorial(N - 1);
+}
+
+// X * 2^E, as a shift for fixed-point types
+template <typename T>
+T _scalb(T const& X, int E){
+#pragma HLS INLINE
+	return (E >= 0) ? (T)(X << E) : (T)(X >> -E);
+}
+
+// The fields of IEEE-754 floats and doubles
+template <typename F>
+struct _ieee;
+
+template <>
+struct _ieee<float>{
+	typedef unsigned int bits_t;
+	static const int MANT = 23;
+	static const int EMAX = 0xff;
+};
+
+template <>
+struct _ieee<double>{
+	typedef unsigned long long bits_t;
+	static const int MANT = 52;
+	static const int EMAX = 0x7ff;
+};
+
+// The bits of a float or double, and back. std::bit_cast where it is
+// available, and std::memcpy (which compiles to a move) before C++20.
+template <typename F>
+typename _ieee<F>::bits_t _ieeeBits(F const& X){
+#pragma HLS INLINE
+#if __cplusplus >= 202002L
+	return std::bit_cast<typename _ieee<F>::bits_t>(X);
+#else
+	typename _ieee<F>::bits_t u;
+	std::memcpy(&u, &X, sizeof(u));
+	return u;
+#endif
+}
+
+template <typename F>
+F _ieeeValue(typename _ieee<F>::bits_t const& U){
+#pragma HLS INLINE
+#if __cplusplus >= 202002L
+	return std::bit_cast<F>(U);
+#else
+	F f;
+	std::memcpy(&f, &U, sizeof(f));
+	return f;
+#endif
+}
+
+// X * 2^E for floating-point types, as an add to the exponent field.
+// Like the HLS floating-point cores, subnormals are flushed to zero:
+// results below the normal range are (signed) zero, and results above it
+// are infinity.
+template <typename F>
+F _ieeeScalb(F const& X, int E){
+#pragma HLS INLINE
+	typedef typename _ieee<F>::bits_t U;
+	static const int MANT = _ieee<F>::MANT;
+	static const int EMAX = _ieee<F>::EMAX;
+	U u = _ieeeBits(X);
+	U sign = u & ((U)1 << (8 * sizeof(F) - 1));
+	int ex = (int)((u >> MANT) & EMAX);
+	if(ex == EMAX){
+		return X;
+	}
+	ex = (ex == 0) ? 0 : ex + E;
+	if(ex <= 0){
+		u = sign;
+	} else if(ex >= EMAX){
+		u = sign | ((U)EMAX << MANT);
+	} else {
+		u = (u & ~((U)EMAX << MANT)) | ((U)ex << MANT);
+	}
+	return _ieeeValue<F>(u);
+}
+
+inline float _scalb(float const& X, int E){
+#pragma HLS INLINE
+	return _ieeeScalb(X, E);
+}
+
+inline double _scalb(double const& X, int E){
+#pragma HLS INLINE
+	return _ieeeScalb(X, E);
+}
+
+constexpr int _iabs(int X){
+	return (X < 0) ? -X : X;
+}
+
+// The largest |E| of a nonzero fixed-point value M * 2^E. ap_fixed and
+// ap_ufixed give their width W and integer width I, and have exponents
+// from I - W + 1 to I. Other types are taken to have no more integer or
+// fractional bits than they have bits.
+template <typename T, typename = void>
+struct _frexpBound{
+	static const int value = 8 * sizeof(T);
+};
+
+template <typename T>
+struct _frexpBound<T, typename std::enable_if<(T::width > 0) && (T::iwidth == T::iwidth)>::type>{
+	static const int value = ((_iabs(T::iwidth) > _iabs(T::width - T::iwidth)) ?
+		_iabs(T::iwidth) : _iabs(T::width - T::iwidth)) + 1;
+};
+
+// The mantissa M of X > 0, in [1/2, 1), and its exponent E, with
+// X = M * 2^E (as std::frexp). For fixed-point types E is found by a
+// binary search, down then up, with steps from STEP down to 1; together
+// they cover every exponent of T (see _frexpBound).
+template <typename T>
+T _frexp(T const& X, int& E){
+#pragma HLS INLINE
+	static const int STEP = 1 << (clog2(_frexpBound<T>::value + 1) - 1);
+	T m = X;
+	E = 0;
+HOPS_LABEL(frexp_down)
+	for(int b = STEP; b > 0; b >>= 1){
+#pragma HLS UNROLL
+		T s = _scalb(m, -b);
+		if(!(s < T(1))){
+			m = s;
+			E += b;
+		}
+	}
+	if(!(m < T(1))){
+		m = _scalb(m, -1);
+		E += 1;
+	}
+HOPS_LABEL(frexp_up)
+	for(int b = STEP; b > 0; b >>= 1){
+#pragma HLS UNROLL
+		// Thresholds below the resolution of T are zero, and never taken
+		if(m < (T)std::ldexp(1.0, -b)){
+			m = _scalb(m, b);
+			E -= b;
+		}
+	}
+	return m;
+}
+
+// frexp for floating-point types: E and M are the exponent field, and X
+// with its exponent field replaced. X must be normal.
+template <typename F>
+F _ieeeFrexp(F const& X, int& E){
+#pragma HLS INLINE
+	typedef typename _ieee<F>::bits_t U;
+	static const int MANT = _ieee<F>::MANT;
+	static const int EMAX = _ieee<F>::EMAX;
+	U u = _ieeeBits(X);
+	E = (int)((u >> MANT) & EMAX) - (EMAX / 2 - 1);
+	u = (u & ~((U)EMAX << MANT)) | ((U)(EMAX / 2 - 1) << MANT);
+	return _ieeeValue<F>(u);
+}
+
+inline float _frexp(float const& X, int& E){
+#pragma HLS INLINE
+	return _ieeeFrexp(X, E);
+}
+
+inline double _frexp(double const& X, int& E){
+#pragma HLS INLINE
+	return _ieeeFrexp(X, E);
+}
+
+// The integer nearest to X: the integer part of X + 1/2, which is wiring
+// for fixed-point types, corrected to round down for negative X
+template <typename T>
+long _round(T const& X){
+#pragma HLS INLINE
+	T h = X + (T)0.5;
+	long q = (long)h;
+	return (h < (T)q) ? q - 1 : q;
+}
+
+// Rotation mode: rotates (X, Y) by Z, which must be within +/- 1.74
+// (the sum of the atan table), and returns the result times the gain
+template <std::size_t ITERS, typename T>
+std::pair<T, T> _cordicRotate(T X, T Y, T Z){
+#pragma HLS INLINE
+	static_assert(ITERS < 48, "Cordic supports at most 47 iterations");
+HOPS_LABEL(cordic_rotate)
+	for(std::size_t i = 0; i < ITERS; ++i){
+#pragma HLS UNROLL
+		T dx = _scalb(Y, -(int)i);
+		T dy = _scalb(X, -(int)i);
+		if(Z < T(0)){
+			X = X + dx;
+			Y = Y - dy;
+			Z = Z + (T)_cordicAtan[i];
+		} else {
+			X = X - dx;
+			Y = Y + dy;
+			Z = Z - (T)_cordicAtan[i];
+		}
+	}
+	return {X, Y};
+}
+
+// Vectoring mode: rotates (X, Y) onto the positive X axis, and returns the
+// final X (the magnitude times the gain) and the angle of (X, Y)
+template <std::size_t ITERS, typename T>
+std::pair<T, T> _cordicVector(T Y, T X){
+#pragma HLS INLINE
+	static_assert(ITERS < 48, "Cordic supports at most 47 iterations");
+	T z = T(0);
+	// Start in the right half-plane
+	if(X < T(0)){
+		z = (Y < T(0)) ? (T)-M_PI : (T)M_PI;
+		X = T(0) - X;
+		Y = T(0) - Y;
+	}
+HOPS_LABEL(cordic_vector)
+	for(std::size_t i = 0; i < ITERS; ++i){
+#pragma HLS UNROLL
+		T dx = _scalb(Y, -(int)i);
+		T dy = _scalb(X, -(int)i);
+		if(Y < T(0)){
+			X = X - dx;
+			Y = Y + dy;
+			z = z - (T)_cordicAtan[i];
+		} else {
+			X = X + dx;
+			Y = Y - dy;
+			z = z + (T)_cordicAtan[i];
+		}
+	}
+	return {X, z};
+}
+
+// (cos, sin) of ANGLE: the quadrant Q is taken out first, so that the
+// CORDIC only sees |R| <= pi/4, and is put back by swapping and negating
+template <std::size_t ITERS, typename T>
+std::pair<T, T> _cordicSinCos(T const& ANGLE){
+#pragma HLS INLINE
+	long q = _round(ANGLE * (T)M_2_PI);
+	T r = ANGLE - (T)q * (T)M_PI_2;
+	std::pair<T, T> cs = _cordicRotate<ITERS>((T)_cordicGain[ITERS], T(0), r);
+	switch(q & 3){
+	case 0:
+		return cs;
+	case 1:
+		return {T(0) - cs.second, cs.first};
+	case 2:
+		return {T(0) - cs.first, T(0) - cs.second};
+	default:
+		return {cs.second, T(0) - cs.first};
+	}
+}
+
+template <class MODE, std::size_t ITERS = 24>
+struct Cordic;
+
+template <std::size_t ITERS>
+struct Cordic<SinCos, ITERS>{
+	template <typename T>
+	std::pair<T, T> operator()(T const& ANGLE){
+#pragma HLS INLINE
+		return _cordicSinCos<ITERS>(ANGLE);
+	}
+};
+
+template <std::size_t ITERS>
+struct Cordic<Sin, ITERS>{
+	template <typename T>
+	T operator()(T const& ANGLE){
+#pragma HLS INLINE
+		return _cordicSinCos<ITERS>(ANGLE).second;
+	}
+};
+
+template <std::size_t ITERS>
+struct Cordic<Cos, ITERS>{
+	template <typename T>
+	T operator()(T const& ANGLE){
+#pragma HLS INLINE
+		return _cordicSinCos<ITERS>(ANGLE).first;
+	}
+};
+
+template <std::size_t ITERS>
+struct Cordic<Atan2, ITERS>{
+	template <typename T>
+	T operator()(T const& Y, T const& X){
+#pragma HLS INLINE
+		return _cordicVector<ITERS>(Y, X).second;
+	}
+};
+
+template <std::size_t ITERS>
+struct Cordic<Hypot, ITERS>{
+	template <typename T>
+	T operator()(T const& Y, T const& X){
+#pragma HLS INLINE
+		return _cordicVector<ITERS>(Y, X).first * (T)_cordicGain[ITERS];
+	}
+};
+
+template <std::size_t DEG = 7>
+struct PolyExp{
+	template <typename T>
+	T operator()(T const& X){
+#pragma HLS INLINE
+		// X = K*ln(2) + R
+		long k = _round(X * (T)M_LOG2E);
+		T r = X - (T)k * (T)M_LN2;
+		T p = (T)(1.0 / _factorial(DEG));
+	HOPS_LABEL(polyexp_horner)
+		for(std::size_t n = DEG; n-- > 0;){
+#pragma HLS UNROLL
+			p = p * r + (T)(1.0 / _factorial(n));
+		}
+		return _scalb(p, (int)k);
+	}
+};
+
+template <std::size_t ITERS = 3>
+struct RSqrt{
+	template <typename T>
+	T operator()(T const& X){
+#pragma HLS INLINE
+		// X = M * 4^E, with M in [1/4, 1)
+		int e;
+		T m = _frexp(X, e);
+		if(e & 1){
+			m = _scalb(m, -1);
+			++e;
+		}
+		e /= 2;
+		// Linear estimate of 1/sqrt(M), within 9% on [1/4, 1)
+		T y = (T)2.13 - (T)1.21 * m;
+	HOPS_LABEL(rsqrt_newton)
+		for(std::size_t i = 0; i < ITERS; ++i){
+#pragma HLS UNROLL
+			y = y * ((T)1.5 - _scalb(m, -1) * y * y);
+		}
+		return _scalb(y, -e);
+	}
+};
+
+template <std::size_t ITERS = 3>
+struct Sqrt{
+	template <typename T>
+	T operator()(T const& X){
+#pragma HLS INLINE
+		return X * RSqrt<ITERS>()(X);
+	}
+};
+#endif // __MATHOPS_HPP
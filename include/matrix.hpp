@@ -0,0 +1,476 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#ifndef __MATRIX_HPP
+#define __MATRIX_HPP
+#include <array>
+#include "listops.hpp"
+#include "zip.hpp"
+#include "reduce.hpp"
+
+// Matrices are row-major std::arrays of std::arrays: an M x N matrix of T
+// is a std::array<std::array<T, N>, M>.
+//
+// matmul and gemv are built around a fully unrolled core that is tiled
+// over larger matrices. The core has one of two mappings:
+//
+// - DotTree: every output of the tile is a zipWith<Mult> followed by a
+//   treereduce<Add>, so a TM x TK x TN core has TM*TN*TK multipliers and
+//   the minimum latency.
+// - Systolic: an output-stationary systolic array of TM x TN
+//   multiply-accumulate cells. A enters from the left and B from the top,
+//   skewed by one cycle per row/column, and both are passed to the
+//   neighbouring cell with shiftr. The whole of K is streamed through the
+//   array for each output tile, and the operands of the next output tile
+//   follow without a gap, so each cell finishes one tile and starts the
+//   next in consecutive cycles. The fill and drain of the array
+//   (TM + TN - 2 cycles) is paid once per matmul, not once per tile: an
+//   M x K x N product takes (M/TM)*(N/TN)*K + TM + TN - 2 cycles, and
+//   every cell multiplies on every cycle in between. TK does not change
+//   the array. gemv is a linear array of TM cells in the same way, and
+//   takes (M/TM)*N + TM - 1 cycles.
+struct DotTree{};
+struct Systolic{};
+
+struct _mmMult{
+	template <typename T>
+	T operator()(T const& L, T const& R){
+#pragma HLS INLINE
+		return L * R;
+	}
+};
+
+struct _mmAdd{
+	template <typename T>
+	T operator()(T const& L, T const& R){
+#pragma HLS INLINE
+		return L + R;
+	}
+};
+
+struct _mmDot{
+	template <typename T, std::size_t LEN>
+	T operator()(std::array<T, LEN> const& L, std::array<T, LEN> const& R){
+#pragma HLS INLINE
+		return treereduce<_mmAdd>(zipWith<_mmMult>(L, R));
+	}
+};
+
+template <typename T, std::size_t M, std::size_t N>
+std::array<std::array<T, M>, N> transpose(std::array<std::array<T, N>, M> const& IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS INLINE
+	std::array<std::array<T, M>, N> temp;
+#pragma HLS ARRAY_PARTITION complete VARIABLE=temp._M_instance
+HOPS_LABEL(transpose_loop)
+	for(std::size_t i = 0; i < M; ++i){
+#pragma HLS UNROLL
+		for(std::size_t j = 0; j < N; ++j){
+#pragma HLS UNROLL
+			temp[j][i] = IN[i][j];
+		}
+	}
+	return temp;
+}
+
+struct Transpose{
+	template <typename T, std::size_t M, std::size_t N>
+	auto operator()(std::array<std::array<T, N>, M> const& IN) -> decltype(transpose(IN)){
+#pragma HLS INLINE
+		return transpose(IN);
+	}
+};
+
+// Corner-turn buffer: an R x C matrix that is written one row at a time
+// and read one column at a time (or the reverse), e.g. between the row
+// and column passes of a 2-D transform. A full row and a full column
+// are each accessed in one cycle, without a partitioned copy of the
+// matrix: element (r, c) is stored in bank (r + c) % max(R, C), so the
+// elements of any row, and of any column, are in different banks. Rows
+// and columns are rotated on their way in and out.
+template <typename T, std::size_t R, std::size_t C>
+class corner_turn{
+public:
+	static constexpr std::size_t BANKS = (R > C) ? R : C;
+	static constexpr std::size_t DEPTH = (R > C) ? C : R;
+	// Partition dim=1 (the banks) completely
+	T banks[BANKS][DEPTH];
+
+	static constexpr std::size_t bank(std::size_t r, std::size_t c){
+		return (r + c) % BANKS;
+	}
+
+	static constexpr std::size_t addr(std::size_t r, std::size_t c){
+		return (R > C) ? c : r;
+	}
+
+	void write_row(std::size_t r, std::array<T, C> const& ROW){
+#pragma HLS INLINE
+		for(std::size_t c = 0; c < C; ++c){
+#pragma HLS UNROLL
+			banks[bank(r, c)][addr(r, c)] = ROW[c];
+		}
+	}
+
+	void write_col(std::size_t c, std::array<T, R> const& COL){
+#pragma HLS INLINE
+		for(std::size_t r = 0; r < R; ++r){
+#pragma HLS UNROLL
+			banks[bank(r, c)][addr(r, c)] = COL[r];
+		}
+	}
+
+	std::array<T, C> read_row(std::size_t r) const{
+#pragma HLS INLINE
+		std::array<T, C> row;
+		for(std::size_t c = 0; c < C; ++c){
+#pragma HLS UNROLL
+			row[c] = banks[bank(r, c)][addr(r, c)];
+		}
+		return row;
+	}
+
+	std::array<T, R> read_col(std::size_t c) const{
+#pragma HLS INLINE
+		std::array<T, R> col;
+		for(std::size_t r = 0; r < R; ++r){
+#pragma HLS UNROLL
+			col[r] = banks[bank(r, c)][addr(r, c)];
+		}
+		return col;
+	}
+};
+
+template <class MAPPING>
+struct _mmCore;
+
+template <>
+struct _mmCore<DotTree>{
+	template <typename T, std::size_t TM, std::size_t TK, std::size_t TN>
+	static std::array<std::array<T, TN>, TM> matmul(std::array<std::array<T, TK>, TM> const& A,
+							std::array<std::array<T, TN>, TK> const& B){
+#pragma HLS INLINE
+		auto bt = transpose(B);
+		std::array<std::array<T, TN>, TM> c;
+#pragma HLS ARRAY_PARTITION complete VARIABLE=c._M_instance
+		for(std::size_t i = 0; i < TM; ++i){
+#pragma HLS UNROLL
+			c[i] = zipWith<_mmDot>(replicate<TN>(A[i]), bt);
+		}
+		return c;
+	}
+
+	template <typename T, std::size_t TM, std::size_t TN>
+	static std::array<T, TM> gemv(std::array<std::array<T, TN>, TM> const& A,
+				std::array<T, TN> const& X){
+#pragma HLS INLINE
+		return zipWith<_mmDot>(A, replicate<TM>(X));
+	}
+};
+
+// The position of an operand in the stream through a systolic array:
+// product K of output tile (TI, TJ)
+struct _mmPos{
+	bool valid;
+	std::size_t k, ti, tj;
+};
+
+// Steps POS to the next position of a stream of TILES_I x TILES_J output
+// tiles of LEN products each. Counters, not divisions, so that the feed
+// of the array is a few adders and compares.
+template <std::size_t LEN, std::size_t TILES_I, std::size_t TILES_J>
+_mmPos _mmNext(_mmPos POS){
+#pragma HLS INLINE
+	if(++POS.k == LEN){
+		POS.k = 0;
+		if(++POS.tj == TILES_J){
+			POS.tj = 0;
+			POS.valid = (++POS.ti < TILES_I);
+		}
+	}
+	return POS;
+}
+
+template <>
+struct _mmCore<Systolic>{
+	// C = A * B streamed through a TM x TN array, one output tile after
+	// another. edge[d] is the stream position that entered the array d
+	// cycles ago: row i of A and column j of B are fed from edge[i] and
+	// edge[j], so cell (i, j) sees the operands of position t - i - j,
+	// and the position itself travels with A in pos.
+	template <std::size_t TM, std::size_t TN, typename T, std::size_t M, std::size_t K, std::size_t N>
+	static std::array<std::array<T, N>, M> tiled(std::array<std::array<T, K>, M> const& A,
+						std::array<std::array<T, N>, K> const& B){
+#pragma HLS INLINE
+		static const std::size_t TILES_I = M / TM, TILES_J = N / TN;
+		static const std::size_t EDGE = (TM > TN) ? TM : TN;
+		std::array<std::array<T, N>, M> c;
+		std::array<std::array<T, TN>, TM> areg, breg, acc;
+#pragma HLS ARRAY_PARTITION complete VARIABLE=areg._M_instance
+#pragma HLS ARRAY_PARTITION complete VARIABLE=breg._M_instance
+#pragma HLS ARRAY_PARTITION complete VARIABLE=acc._M_instance
+		areg = breg = acc = replicate<TM>(replicate<TN>(T()));
+		const _mmPos idle = {false, 0, 0, 0};
+		std::array<_mmPos, EDGE> edge = replicate<EDGE>(idle);
+		std::array<std::array<_mmPos, TN>, TM> pos = replicate<TM>(replicate<TN>(idle));
+#pragma HLS ARRAY_PARTITION complete VARIABLE=edge._M_instance
+#pragma HLS ARRAY_PARTITION complete VARIABLE=pos._M_instance
+		_mmPos next = {true, 0, 0, 0};
+	HOPS_LABEL(systolic_cycle_loop)
+		for(std::size_t t = 0; t < TILES_I * TILES_J * K + TM + TN - 2; ++t){
+#pragma HLS PIPELINE II=1
+			edge = shiftr(next, edge);
+			next = _mmNext<K, TILES_I, TILES_J>(next);
+			std::array<T, TN> top;
+#pragma HLS ARRAY_PARTITION complete VARIABLE=top._M_instance
+			for(std::size_t j = 0; j < TN; ++j){
+#pragma HLS UNROLL
+				top[j] = edge[j].valid ? B[edge[j].k][edge[j].tj * TN + j] : T();
+			}
+			breg = shiftr(top, breg);
+			for(std::size_t i = 0; i < TM; ++i){
+#pragma HLS UNROLL
+				areg[i] = shiftr(edge[i].valid ? A[edge[i].ti * TM + i][edge[i].k] : T(), areg[i]);
+				pos[i] = shiftr(edge[i], pos[i]);
+				for(std::size_t j = 0; j < TN; ++j){
+#pragma HLS UNROLL
+					_mmPos const& p = pos[i][j];
+					if(p.valid){
+						T prod = areg[i][j] * breg[i][j];
+						acc[i][j] = (p.k == 0) ? prod : acc[i][j] + prod;
+						if(p.k == K - 1){
+							c[p.ti * TM + i][p.tj * TN + j] = acc[i][j];
+						}
+					}
+				}
+			}
+		}
+		return c;
+	}
+
+	template <typename T, std::size_t TM, std::size_t TK, std::size_t TN>
+	static std::array<std::array<T, TN>, TM> matmul(std::array<std::array<T, TK>, TM> const& A,
+							std::array<std::array<T, TN>, TK> const& B){
+#pragma HLS INLINE
+		return tiled<TM, TN>(A, B);
+	}
+
+	// y = A * x streamed through a linear array of TM cells, one tile of
+	// TM rows after another: X enters the first cell and is shifted down
+	// the array, and row i of A is fed to cell i skewed by i cycles.
+	template <std::size_t TM, typename T, std::size_t M, std::size_t N>
+	static std::array<T, M> tiled(std::array<std::array<T, N>, M> const& A,
+				std::array<T, N> const& X){
+#pragma HLS INLINE
+		static const std::size_t TILES_I = M / TM;
+		std::array<T, M> y;
+		std::array<T, TM> xreg, acc;
+#pragma HLS ARRAY_PARTITION complete VARIABLE=xreg._M_instance
+#pragma HLS ARRAY_PARTITION complete VARIABLE=acc._M_instance
+		xreg = acc = replicate<TM>(T());
+		const _mmPos idle = {false, 0, 0, 0};
+		std::array<_mmPos, TM> pos = replicate<TM>(idle);
+#pragma HLS ARRAY_PARTITION complete VARIABLE=pos._M_instance
+		_mmPos next = {true, 0, 0, 0};
+	HOPS_LABEL(systolic_cycle_loop)
+		for(std::size_t t = 0; t < TILES_I * N + TM - 1; ++t){
+#pragma HLS PIPELINE II=1
+			xreg = shiftr(next.valid ? X[next.k] : T(), xreg);
+			pos = shiftr(next, pos);
+			next = _mmNext<N, TILES_I, 1>(next);
+			for(std::size_t i = 0; i < TM; ++i){
+#pragma HLS UNROLL
+				_mmPos const& p = pos[i];
+				if(p.valid){
+					T prod = A[p.ti * TM + i][p.k] * xreg[i];
+					acc[i] = (p.k == 0) ? prod : acc[i] + prod;
+					if(p.k == N - 1){
+						y[p.ti * TM + i] = acc[i];
+					}
+				}
+			}
+		}
+		return y;
+	}
+
+	template <typename T, std::size_t TM, std::size_t TN>
+	static std::array<T, TM> gemv(std::array<std::array<T, TN>, TM> const& A,
+				std::array<T, TN> const& X){
+#pragma HLS INLINE
+		return tiled<TM>(A, X);
+	}
+};
+
+template <std::size_t TR, std::size_t TC, typename T, std::size_t R, std::size_t C>
+std::array<std::array<T, TC>, TR> _tile(std::array<std::array<T, C>, R> const& IN, std::size_t R0, std::size_t C0){
+#pragma HLS INLINE
+	std::array<std::array<T, TC>, TR> temp;
+#pragma HLS ARRAY_PARTITION complete VARIABLE=temp._M_instance
+	for(std::size_t i = 0; i < TR; ++i){
+#pragma HLS UNROLL
+		for(std::size_t j = 0; j < TC; ++j){
+#pragma HLS UNROLL
+			temp[i][j] = IN[R0 + i][C0 + j];
+		}
+	}
+	return temp;
+}
+
+// The tiled product on the DotTree core: the core is applied to every
+// TM x TK x TN tile, and the partial products of each output tile are
+// summed over K
+template <std::size_t TM, std::size_t TK, std::size_t TN, typename T, std::size_t M, std::size_t K, std::size_t N>
+std::array<std::array<T, N>, M> _matmul(std::array<std::array<T, K>, M> const& A,
+				std::array<std::array<T, N>, K> const& B, DotTree){
+#pragma HLS INLINE
+	std::array<std::array<T, N>, M> c;
+HOPS_LABEL(matmul_row_loop)
+	for(std::size_t ti = 0; ti < M; ti += TM){
+	HOPS_LABEL(matmul_col_loop)
+		for(std::size_t tj = 0; tj < N; tj += TN){
+			std::array<std::array<T, TN>, TM> acc = replicate<TM>(replicate<TN>(T()));
+#pragma HLS ARRAY_PARTITION complete VARIABLE=acc._M_instance
+		HOPS_LABEL(matmul_inner_loop)
+			for(std::size_t tk = 0; tk < K; tk += TK){
+#pragma HLS PIPELINE
+				auto p = _mmCore<DotTree>::matmul(_tile<TM, TK>(A, ti, tk), _tile<TK, TN>(B, tk, tj));
+				acc = zipWith<ZipWith<_mmAdd>>(acc, p);
+			}
+			for(std::size_t i = 0; i < TM; ++i){
+#pragma HLS UNROLL
+				for(std::size_t j = 0; j < TN; ++j){
+#pragma HLS UNROLL
+					c[ti + i][tj + j] = acc[i][j];
+				}
+			}
+		}
+	}
+	return c;
+}
+
+// The tiled product on the Systolic array streams every output tile
+// through one TM x TN array
+template <std::size_t TM, std::size_t TK, std::size_t TN, typename T, std::size_t M, std::size_t K, std::size_t N>
+std::array<std::array<T, N>, M> _matmul(std::array<std::array<T, K>, M> const& A,
+				std::array<std::array<T, N>, K> const& B, Systolic){
+#pragma HLS INLINE
+	return _mmCore<Systolic>::tiled<TM, TN>(A, B);
+}
+
+// C = A * B for an M x K matrix A and a K x N matrix B, computed with a
+// TM x TK x TN core. The tile sizes must divide the matrix sizes; with
+// TM = M, TK = K and TN = N the whole product is one (untiled) core.
+template <std::size_t TM, std::size_t TK, std::size_t TN, class MAPPING = DotTree,
+	typename T, std::size_t M, std::size_t K, std::size_t N>
+std::array<std::array<T, N>, M> matmul(std::array<std::array<T, K>, M> const& A,
+				std::array<std::array<T, N>, K> const& B){
+#pragma HLS INLINE
+	static_assert(M % TM == 0 && K % TK == 0 && N % TN == 0, "Tile sizes must divide the matrix sizes");
+	return _matmul<TM, TK, TN>(A, B, MAPPING());
+}
+
+template <class MAPPING = DotTree, typename T, std::size_t M, std::size_t K, std::size_t N>
+std::array<std::array<T, N>, M> matmul(std::array<std::array<T, K>, M> const& A,
+				std::array<std::array<T, N>, K> const& B){
+#pragma HLS INLINE
+	return _mmCore<MAPPING>::matmul(A, B);
+}
+
+template <std::size_t TM, std::size_t TN, typename T, std::size_t M, std::size_t N>
+std::array<T, M> _gemv(std::array<std::array<T, N>, M> const& A, std::array<T, N> const& X, DotTree){
+#pragma HLS INLINE
+	std::array<T, M> y;
+HOPS_LABEL(gemv_row_loop)
+	for(std::size_t ti = 0; ti < M; ti += TM){
+		std::array<T, TM> acc = replicate<TM>(T());
+#pragma HLS ARRAY_PARTITION complete VARIABLE=acc._M_instance
+	HOPS_LABEL(gemv_inner_loop)
+		for(std::size_t tj = 0; tj < N; tj += TN){
+#pragma HLS PIPELINE
+			std::array<T, TN> x;
+#pragma HLS ARRAY_PARTITION complete VARIABLE=x._M_instance
+			for(std::size_t j = 0; j < TN; ++j){
+#pragma HLS UNROLL
+				x[j] = X[tj + j];
+			}
+			acc = zipWith<_mmAdd>(acc, _mmCore<DotTree>::gemv(_tile<TM, TN>(A, ti, tj), x));
+		}
+		for(std::size_t i = 0; i < TM; ++i){
+#pragma HLS UNROLL
+			y[ti + i] = acc[i];
+		}
+	}
+	return y;
+}
+
+template <std::size_t TM, std::size_t TN, typename T, std::size_t M, std::size_t N>
+std::array<T, M> _gemv(std::array<std::array<T, N>, M> const& A, std::array<T, N> const& X, Systolic){
+#pragma HLS INLINE
+	return _mmCore<Systolic>::tiled<TM>(A, X);
+}
+
+// y = A * x for an M x N matrix A, computed with a TM x TN core.
+template <std::size_t TM, std::size_t TN, class MAPPING = DotTree,
+	typename T, std::size_t M, std::size_t N>
+std::array<T, M> gemv(std::array<std::array<T, N>, M> const& A, std::array<T, N> const& X){
+#pragma HLS INLINE
+	static_assert(M % TM == 0 && N % TN == 0, "Tile sizes must divide the matrix sizes");
+	return _gemv<TM, TN>(A, X, MAPPING());
+}
+
+template <class MAPPING = DotTree, typename T, std::size_t M, std::size_t N>
+std::array<T, M> gemv(std::array<std::array<T, N>, M> const& A, std::array<T, N> const& X){
+#pragma HLS INLINE
+	return _mmCore<MAPPING>::gemv(A, X);
+}
+
+template <std::size_t TM, std::size_t TK, std::size_t TN, class MAPPING = DotTree>
+struct Matmul{
+	template <typename T, std::size_t M, std::size_t K, std::size_t N>
+	auto operator()(std::array<std::array<T, K>, M> const& A,
+			std::array<std::array<T, N>, K> const& B) -> decltype(matmul<TM, TK, TN, MAPPING>(A, B)){
+#pragma HLS INLINE
+		return matmul<TM, TK, TN, MAPPING>(A, B);
+	}
+};
+
+template <std::size_t TM, std::size_t TN, class MAPPING = DotTree>
+struct Gemv{
+	template <typename T, std::size_t M, std::size_t N>
+	auto operator()(std::array<std::array<T, N>, M> const& A, std::array<T, N> const& X) -> decltype(gemv<TM, TN, MAPPING>(A, X)){
+#pragma HLS INLINE
+		return gemv<TM, TN, MAPPING>(A, X);
+	}
+};
+#endif // __MATRIX_HPP
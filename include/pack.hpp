@@ -0,0 +1,286 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#ifndef __PACK_HPP
+#define __PACK_HPP
+#include <cstddef>
+#include <array>
+#include <cstring>
+#include <type_traits>
+#include "constops.hpp"
+
+// Width conversion between lists of narrow elements and lists of W-bit
+// words, so that narrow data (e.g. the chars of map<Truncate>) moves over
+// a wide memory bus at full bandwidth:
+//
+// - pack<W>(IN): std::array<T, LEN> to std::array<word_t<W>, N>, where
+//   each word holds 2^(clog2(W) - clog2(bits of T)) elements, lowest
+//   lane first, and N is LEN divided by that, rounded up. Lanes past LEN
+//   in the last word are zero.
+// - unpack<T, LEN>(IN): the inverse; W comes from the word type.
+//
+// W and the element width must be powers of two, with W at least the
+// element width, and elements must be trivially copyable, of at most 8
+// bytes. Lane I of a word is bits [I*B, (I+1)*B): integral elements are
+// converted to and from B bits, and the bits of other elements are
+// reinterpreted (with std::memcpy). Under synthesis word_t<W> is
+// ap_uint<W>. In C-sim it is a model of one, W bits held in W/8 bytes of
+// unsigned integers, and pack and unpack run the same lane-by-lane loops
+// as synthesis. On a little-endian host a word has the same bytes as a
+// std::memcpy of its elements.
+template <typename T, std::size_t W>
+constexpr std::size_t _laneShift(){
+	return clog2(W) - clog2(8 * sizeof(T));
+}
+
+template <typename T, std::size_t W, std::size_t LEN>
+constexpr std::size_t _packWords(){
+	return (LEN + (1 << _laneShift<T, W>()) - 1) >> _laneShift<T, W>();
+}
+
+// The unsigned integer of BYTES bytes
+template <std::size_t BYTES>
+struct _laneUint;
+
+template <>
+struct _laneUint<1>{
+	typedef unsigned char type;
+};
+
+template <>
+struct _laneUint<2>{
+	typedef unsigned short type;
+};
+
+template <>
+struct _laneUint<4>{
+	typedef unsigned int type;
+};
+
+template <>
+struct _laneUint<8>{
+	typedef unsigned long long type;
+};
+
+#ifdef __SYNTHESIS__
+#include "ap_int.h"
+
+template <std::size_t W>
+using word_t = ap_uint<W>;
+
+// The width of a word type (ap_uint takes an int width, so W cannot be
+// deduced as a std::size_t from word_t<W>)
+template <class WORD>
+struct _wordBits;
+
+template <int W>
+struct _wordBits<ap_uint<W> > : std::integral_constant<std::size_t, W>{};
+
+template <std::size_t B>
+using _lane_t = ap_uint<B>;
+
+template <std::size_t W>
+word_t<W> _wordZero(){
+#pragma HLS INLINE
+	return 0;
+}
+
+// Lane L of B bits of X
+template <std::size_t B, class WORD>
+_lane_t<B> _wordLane(WORD const& X, std::size_t L){
+#pragma HLS INLINE
+	return (_lane_t<B>)X.range(L * B + B - 1, L * B);
+}
+
+template <std::size_t B, class WORD>
+void _setWordLane(WORD& X, std::size_t L, _lane_t<B> const& V){
+#pragma HLS INLINE
+	X.range(L * B + B - 1, L * B) = V;
+}
+#else
+// W bits, as W/8 bytes of unsigned integers of up to 64 bits (so that a
+// word is W/8 bytes, like the ap_uint<W> it models)
+template <std::size_t W>
+struct word_t{
+	static const std::size_t LIMB = (W < 64) ? W : 64;
+	static const std::size_t LIMBS = W / LIMB;
+	typedef typename _laneUint<LIMB / 8>::type limb_t;
+
+	limb_t limbs[LIMBS];
+
+	word_t() : limbs(){}
+
+	bool operator==(word_t const& R) const{
+		return std::memcmp(limbs, R.limbs, sizeof(limbs)) == 0;
+	}
+
+	bool operator!=(word_t const& R) const{
+		return !(*this == R);
+	}
+};
+
+template <class WORD>
+struct _wordBits;
+
+template <std::size_t W>
+struct _wordBits<word_t<W> > : std::integral_constant<std::size_t, W>{};
+
+// A lane of B bits, in the low bits of a 64-bit integer
+template <std::size_t B>
+using _lane_t = unsigned long long;
+
+template <std::size_t W>
+word_t<W> _wordZero(){
+	return word_t<W>();
+}
+
+// A lane never crosses a limb: both are powers of two, and a limb is at
+// least as wide as a lane
+template <std::size_t B, class WORD>
+_lane_t<B> _wordLane(WORD const& X, std::size_t L){
+	static const std::size_t LIMB = WORD::LIMB;
+	static const unsigned long long MASK = (B == 64) ? ~0ULL : (1ULL << (B % 64)) - 1;
+	return ((unsigned long long)X.limbs[L * B / LIMB] >> (L * B % LIMB)) & MASK;
+}
+
+template <std::size_t B, class WORD>
+void _setWordLane(WORD& X, std::size_t L, _lane_t<B> const& V){
+	typedef typename WORD::limb_t limb_t;
+	static const std::size_t LIMB = WORD::LIMB;
+	static const unsigned long long MASK = (B == 64) ? ~0ULL : (1ULL << (B % 64)) - 1;
+	limb_t& limb = X.limbs[L * B / LIMB];
+	std::size_t shift = L * B % LIMB;
+	limb = (limb_t)((limb & ~(limb_t)(MASK << shift)) | (limb_t)((V & MASK) << shift));
+}
+#endif
+
+// The bits of X: integral elements are converted, and every other type
+// (float, double, small structs) is reinterpreted
+template <std::size_t B, typename T>
+typename std::enable_if<std::is_integral<T>::value, _lane_t<B> >::type _laneBits(T const& X){
+#pragma HLS INLINE
+	return (_lane_t<B>)(typename _laneUint<sizeof(T)>::type)X;
+}
+
+template <std::size_t B, typename T>
+typename std::enable_if<!std::is_integral<T>::value, _lane_t<B> >::type _laneBits(T const& X){
+#pragma HLS INLINE
+	typename _laneUint<sizeof(T)>::type u;
+	std::memcpy(&u, &X, sizeof(T));
+	return (_lane_t<B>)u;
+}
+
+template <typename T, std::size_t B>
+typename std::enable_if<std::is_integral<T>::value, T>::type _laneValue(_lane_t<B> const& X){
+#pragma HLS INLINE
+	return (T)(typename _laneUint<sizeof(T)>::type)X;
+}
+
+template <typename T, std::size_t B>
+typename std::enable_if<!std::is_integral<T>::value, T>::type _laneValue(_lane_t<B> const& X){
+#pragma HLS INLINE
+	typename _laneUint<sizeof(T)>::type u = (typename _laneUint<sizeof(T)>::type)X;
+	T t;
+	std::memcpy(&t, &u, sizeof(T));
+	return t;
+}
+
+template <std::size_t W, typename T, std::size_t LEN>
+std::array<word_t<W>, _packWords<T, W, LEN>()> pack(std::array<T, LEN> const& IN){
+#pragma HLS INLINE
+	static_assert((1 << clog2(8 * sizeof(T))) == 8 * sizeof(T) && (1 << clog2(W)) == W &&
+		W >= 8 * sizeof(T), "W and the element width must be powers of two, with W at least the element width");
+	static_assert(std::is_trivially_copyable<T>::value && sizeof(T) <= 8,
+		"Elements must be trivially copyable, of at most 8 bytes");
+	static const std::size_t N = _packWords<T, W, LEN>();
+	static const std::size_t B = 8 * sizeof(T);
+	static const std::size_t LANES = 1 << _laneShift<T, W>();
+	std::array<word_t<W>, N> out;
+HOPS_LABEL(pack_loop)
+	for(std::size_t w = 0; w < N; ++w){
+#pragma HLS PIPELINE
+		word_t<W> word = _wordZero<W>();
+		for(std::size_t l = 0; l < LANES; ++l){
+#pragma HLS UNROLL
+			if(w * LANES + l < LEN){
+				_setWordLane<B>(word, l, _laneBits<B>(IN[w * LANES + l]));
+			}
+		}
+		out[w] = word;
+	}
+	return out;
+}
+
+template <typename T, std::size_t LEN, class WORD, std::size_t N>
+std::array<T, LEN> unpack(std::array<WORD, N> const& IN){
+#pragma HLS INLINE
+	static const std::size_t W = _wordBits<WORD>::value;
+	static_assert(N == _packWords<T, W, LEN>(), "The number of words does not match LEN");
+	static_assert(std::is_trivially_copyable<T>::value && sizeof(T) <= 8,
+		"Elements must be trivially copyable, of at most 8 bytes");
+	static const std::size_t B = 8 * sizeof(T);
+	static const std::size_t LANES = 1 << _laneShift<T, W>();
+	std::array<T, LEN> out;
+HOPS_LABEL(unpack_loop)
+	for(std::size_t w = 0; w < N; ++w){
+#pragma HLS PIPELINE
+		word_t<W> word = IN[w];
+		for(std::size_t l = 0; l < LANES; ++l){
+#pragma HLS UNROLL
+			if(w * LANES + l < LEN){
+				out[w * LANES + l] = _laneValue<T, B>(_wordLane<B>(word, l));
+			}
+		}
+	}
+	return out;
+}
+
+template <std::size_t W>
+struct Pack{
+	template <typename T, std::size_t LEN>
+	auto operator()(std::array<T, LEN> const& IN) -> decltype(pack<W>(IN)){
+#pragma HLS INLINE
+		return pack<W>(IN);
+	}
+};
+
+template <typename T, std::size_t LEN>
+struct Unpack{
+	template <class WORD, std::size_t N>
+	std::array<T, LEN> operator()(std::array<WORD, N> const& IN){
+#pragma HLS INLINE
+		return unpack<T, LEN>(IN);
+	}
+};
+#endif // __PACK_HPP
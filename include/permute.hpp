@@ -0,0 +1,133 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#ifndef __PERMUTE_HPP
+#define __PERMUTE_HPP
+#include <array>
+#include <type_traits>
+#include "constops.hpp"
+
+// permute<PERM>(IN) reorders IN so that OUT[i] = IN[PERM::index(LEN, i)].
+// PERM::index must be a constexpr function, so once the loop is unrolled
+// every index is a constant and the permutation is pure wiring. PERM can
+// be any class with a member of the form:
+//
+//	static constexpr std::size_t index(std::size_t LEN, std::size_t I);
+
+constexpr std::size_t _brev(std::size_t V, std::size_t BITS){
+	return BITS == 0 ? 0 : ((V & 1) << (BITS - 1)) | _brev(V >> 1, BITS - 1);
+}
+
+// Bit-reversal: OUT[i] = IN[bitreverse(i)] for a power-of-two LEN
+struct BitReversePerm{
+	static constexpr std::size_t index(std::size_t LEN, std::size_t I){
+		return _brev(I, hlog2(LEN));
+	}
+};
+
+// Radix of the outermost split of a mixed-radix FFT of LEN points: 2, 3
+// or 5 when it divides LEN, and LEN itself (a direct DFT) otherwise
+constexpr std::size_t _mrRadix(std::size_t LEN){
+	return (LEN % 2 == 0) ? 2 : (LEN % 3 == 0) ? 3 : (LEN % 5 == 0) ? 5 : LEN;
+}
+
+// Digit reversal, the input order of a mixed-radix FFT: I is read as
+// digits in the radices _mrRadix picks for LEN, LEN/R, ..., which are
+// written out in reverse. For a power-of-two LEN this is BitReversePerm.
+struct DigitReversePerm{
+	static constexpr std::size_t index(std::size_t LEN, std::size_t I){
+		return (LEN == 1) ? 0 : 
+			_mrRadix(LEN) * index(LEN / _mrRadix(LEN), I % (LEN / _mrRadix(LEN))) + I / (LEN / _mrRadix(LEN));
+	}
+};
+
+// Perfect shuffle: interleaves the two halves of IN, so that
+// OUT[2k] = IN[k] and OUT[2k+1] = IN[LEN/2 + k]
+struct ShufflePerm{
+	static constexpr std::size_t index(std::size_t LEN, std::size_t I){
+		return (I >> 1) + (I & 1) * (LEN / 2);
+	}
+};
+
+// Stride permutation L^LEN_S: reads IN at stride S, i.e. views IN as a 
+// (LEN/S) x S row-major matrix and reads it out column by column
+template <std::size_t S>
+struct StridePerm{
+	static constexpr std::size_t index(std::size_t LEN, std::size_t I){
+		return (I % (LEN / S)) * S + I / (LEN / S);
+	}
+};
+
+// Transpose of an R x C row-major matrix stored in a flat array of
+// LEN = R * C elements
+template <std::size_t R, std::size_t C>
+struct TransposePerm{
+	static constexpr std::size_t index(std::size_t LEN, std::size_t I){
+		return (I % R) * (LEN / R) + I / R;
+	}
+};
+
+// True if PERM is a permutation of LEN elements. Permutations of a fixed
+// shape specialize this, so that permute rejects other lengths.
+template <class PERM, std::size_t LEN>
+struct _permFits : std::true_type{};
+
+template <std::size_t R, std::size_t C, std::size_t LEN>
+struct _permFits<TransposePerm<R, C>, LEN> : std::integral_constant<bool, R * C == LEN>{};
+
+template <class PERM, typename TA, std::size_t LEN>
+CONSTEXPR17 std::array<TA, LEN> permute(std::array<TA, LEN> const& IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS INLINE
+	static_assert(_permFits<PERM, LEN>::value, "PERM does not permute LEN elements");
+	std::array<TA, LEN> temp{};
+#pragma HLS ARRAY_PARTITION complete VARIABLE=temp._M_instance
+CONSTEXPR17_LABEL(permute_loop)
+	for(std::size_t i = 0; i < LEN; ++i){
+#pragma HLS UNROLL
+		temp[i] = IN[PERM::index(LEN, i)];
+	}
+	return temp;
+}
+
+template <class PERM>
+struct Permute{
+	template <typename TA, std::size_t LEN>
+	CONSTEXPR17 std::array<TA, LEN> operator()(std::array<TA, LEN> const& IN){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS INLINE
+		return permute<PERM>(IN);
+	}
+};
+#endif // __PERMUTE_HPP
@@ -0,0 +1,103 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#ifndef __POLICY_HPP
+#define __POLICY_HPP
+#include <cstddef>
+
+// Execution policies select how map, zipWith, reduce, rreduce and divconq
+// are implemented, without changing what they compute. The policy is the
+// second template argument, e.g. map<FTOR, folded<4>>(IN):
+//
+// - unrolled:  one operator per element, fully unrolled and partitioned
+//              (the default when no policy is given).
+// - folded<F>: F operators, reused over LEN/F pipelined iterations. The
+//              arrays are partitioned cyclically by F.
+// - streaming: one operator, one element per cycle, with unpartitioned
+//              arrays that can be mapped to FIFOs (folded<1>).
+// - host_par:  C-sim only; splits the work across host threads. Under
+//              synthesis it is the same as unrolled.
+//
+// Policies other than unrolled build loops rather than recursive types,
+// so FTOR must map elements to a single result type (e.g. divconq<Min>,
+// but not divconq<Interleave>).
+struct unrolled{};
+
+template <std::size_t F>
+struct folded{};
+
+struct streaming{};
+
+#ifdef __SYNTHESIS__
+typedef unrolled host_par;
+#else
+#include <thread>
+#include <vector>
+struct host_par{};
+
+// The number of host threads to split LEN items over: one per hardware
+// thread, but no more than LEN, and at least one (so that it can be
+// divided by, even when LEN is 0).
+inline std::size_t _host_threads(std::size_t LEN){
+	std::size_t n = std::thread::hardware_concurrency();
+	n = (n > LEN) ? LEN : n;
+	return (n == 0) ? 1 : n;
+}
+
+// Calls FN(i) for every i in [0, LEN), in contiguous chunks, one chunk
+// per hardware thread.
+template <class FN>
+void _host_parallel_for(std::size_t LEN, FN const& F){
+	if(LEN == 0){
+		return;
+	}
+	std::size_t n = _host_threads(LEN);
+	std::size_t chunk = (LEN + n - 1) / n;
+	std::vector<std::thread> threads;
+	for(std::size_t t = 1; t < n; ++t){
+		threads.emplace_back([&F, t, chunk, LEN](){
+				for(std::size_t i = t * chunk; i < (t + 1) * chunk && i < LEN; ++i){
+					F(i);
+				}
+			});
+	}
+	for(std::size_t i = 0; i < chunk && i < LEN; ++i){
+		F(i);
+	}
+	for(std::thread& t : threads){
+		t.join();
+	}
+}
+#endif // __SYNTHESIS__
+#endif // __POLICY_HPP
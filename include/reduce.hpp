@@ -36,76 +36,395 @@
 #define __REDUCE_HPP
 #include <array>
 #include "listops.hpp"
-template <class FTOR, std::size_t LEV>
+#include "stream.hpp"
+#include "traits.hpp"
+#include "policy.hpp"
+
+// _rHelp<FTOR, LEV, END> reduces the LEV elements of IN that end at END
+// (by default, the last LEV elements). IN is passed down the chain by
+// reference and indexed, rather than split with head and tail, so the
+// chain does not copy the list at every step.
+template <class FTOR, std::size_t LEV, std::size_t END = LEV>
 struct _rHelp{
-	template<typename TI, typename TA>
-	static auto reduce(TI const& INIT, std::array<TA, LEV> const& IN)
-		-> decltype(_rHelp<FTOR, LEV-1>().reduce(FTOR()(INIT, head(IN)), tail(IN))){
+	template<typename TI, typename TA, std::size_t LEN>
+	static CONSTEXPR17 auto reduce(TI const& INIT, std::array<TA, LEN> const& IN)
+		-> decltype(_rHelp<FTOR, LEV-1, END>::reduce(FTOR()(INIT, IN[END - LEV]), IN)){
 #pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
 #pragma HLS INLINE
-		return _rHelp<FTOR, LEV-1>::reduce(FTOR()(INIT, head(IN)), tail(IN));
+		return _rHelp<FTOR, LEV-1, END>::reduce(FTOR()(INIT, IN[END - LEV]), IN);
 	}
 
-	template<typename TI, typename TA>
-	static auto rreduce(std::array<TA, LEV> const& IN, TI const& INIT)
-		-> decltype(FTOR()(head(IN), _rHelp<FTOR, LEV-1>().rreduce(tail(IN), INIT))){
+	template<typename TI, typename TA, std::size_t LEN>
+	static CONSTEXPR17 auto rreduce(std::array<TA, LEN> const& IN, TI const& INIT)
+		-> decltype(FTOR()(IN[END - LEV], _rHelp<FTOR, LEV-1, END>::rreduce(IN, INIT))){
 #pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
 #pragma HLS INLINE
-		return FTOR()(head(IN), _rHelp<FTOR, LEV-1>::rreduce(tail(IN), INIT));
+		return FTOR()(IN[END - LEV], _rHelp<FTOR, LEV-1, END>::rreduce(IN, INIT));
 	}
 };
 
-template <class FTOR>
-struct _rHelp<FTOR, 0>{
-	template<typename TI, typename TA>
-	static auto reduce(TI const& INIT, std::array<TA, 0> const& IN) -> TI{
+template <class FTOR, std::size_t END>
+struct _rHelp<FTOR, 0, END>{
+	template<typename TI, typename TA, std::size_t LEN>
+	static CONSTEXPR17 auto reduce(TI const& INIT, std::array<TA, LEN> const&) -> TI{
 #pragma HLS INLINE
 		return INIT;
 	}
 
-	template<typename TI, typename TA>
-	static auto rreduce(std::array<TA, 0> const& IN, TI const& INIT) -> TI{
+	template<typename TI, typename TA, std::size_t LEN>
+	static CONSTEXPR17 auto rreduce(std::array<TA, LEN> const&, TI const& INIT) -> TI{
 #pragma HLS INLINE
 		return INIT;
 	}
 };
 
-template <class FTOR, typename TI, typename TA, std::size_t LEN>
-auto reduce(TI const& INIT, std::array<TA, LEN> const& IN) -> decltype(_rHelp<FTOR, LEN>::reduce(INIT, IN)){
+// _trHelp<FTOR, LEV, LEN, OFF> reduces the LEN elements of IN starting at
+// OFF, and indexes IN in the same way as _rHelp.
+template <class FTOR, std::size_t LEV, std::size_t LEN, std::size_t OFF = 0>
+struct _trHelp{
+	template<typename TA, std::size_t N>
+	static CONSTEXPR17 auto treereduce(std::array<TA, N> const& IN)
+		-> decltype(FTOR()(_trHelp<FTOR, LEV-1, LEN/2, OFF>::treereduce(IN),
+				_trHelp<FTOR, LEV-1, LEN - LEN/2, OFF + LEN/2>::treereduce(IN))){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS INLINE
+		return FTOR()(_trHelp<FTOR, LEV-1, LEN/2, OFF>::treereduce(IN),
+			_trHelp<FTOR, LEV-1, LEN - LEN/2, OFF + LEN/2>::treereduce(IN));
+	}
+};
+
+template <class FTOR, std::size_t LEV, std::size_t OFF>
+struct _trHelp<FTOR, LEV, 1, OFF>{
+	template<typename TA, std::size_t N>
+	static CONSTEXPR17 TA treereduce(std::array<TA, N> const& IN){
+#pragma HLS INLINE
+		return IN[OFF];
+	}
+};
+
+template <class FTOR, std::size_t LEN, std::size_t OFF>
+struct _trHelp<FTOR, 0, LEN, OFF>{
+	template<typename TA, std::size_t N>
+	static CONSTEXPR17 auto treereduce(std::array<TA, N> const& IN)
+		-> decltype(_rHelp<FTOR, LEN-1, OFF + LEN>::reduce(IN[OFF], IN)){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS INLINE
+		return _rHelp<FTOR, LEN-1, OFF + LEN>::reduce(IN[OFF], IN);
+	}
+};
+
+template <class FTOR, std::size_t OFF>
+struct _trHelp<FTOR, 0, 1, OFF>{
+	template<typename TA, std::size_t N>
+	static CONSTEXPR17 TA treereduce(std::array<TA, N> const& IN){
+#pragma HLS INLINE
+		return IN[OFF];
+	}
+};
+
+// Reduces IN with a balanced tree of (at most) LEV levels of FTOR. Each
+// leaf of the tree is reduced with a chain, so LEV = 0 is a plain chain
+// and LEV >= clog2(LEN) is a full tree. FTOR must be associative.
+//
+// The tree always splits a list of length LEN into LEN/2 and LEN - LEN/2,
+// so its shape (and the order of floating-point operations) depends only
+// on LEN and LEV. For power-of-two LEN the full tree is the same as 
+// divconq.
+template <class FTOR, std::size_t LEV, typename TA, std::size_t LEN>
+CONSTEXPR17 auto treereduce(std::array<TA, LEN> const& IN) -> decltype(_trHelp<FTOR, LEV, LEN>::treereduce(IN)){
 #pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
 #pragma HLS INLINE
 #pragma HLS PIPELINE
-	return _rHelp<FTOR, LEN>::reduce(INIT, IN);
+	return _trHelp<FTOR, LEV, LEN>::treereduce(IN);
 }
 
-template <class FTOR>
-struct Reduce{
-	template <typename TI, typename TA, std::size_t LEN>
-	auto operator()(TI const& INIT, std::array<TA, LEN> const& IN) -> decltype(reduce<FTOR>(INIT, IN)){
+template <class FTOR, typename TA, std::size_t LEN>
+CONSTEXPR17 auto treereduce(std::array<TA, LEN> const& IN) -> decltype(_trHelp<FTOR, clog2(LEN), LEN>::treereduce(IN)){
 #pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
 #pragma HLS INLINE
 #pragma HLS PIPELINE
-		return reduce<FTOR>(INIT, IN);
+	return _trHelp<FTOR, clog2(LEN), LEN>::treereduce(IN);
+}
+
+template <class FTOR, std::size_t LEV = 64>
+struct Treereduce{
+	template <typename TA, std::size_t LEN>
+	CONSTEXPR17 auto operator()(std::array<TA, LEN> const& IN) -> decltype(treereduce<FTOR, LEV>(IN)){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS INLINE
+		return treereduce<FTOR, LEV>(IN);
 	}
 };
+// reduce and rreduce build a chain of FTOR, unless FTOR is marked 
+// associative (see traits.hpp) and INIT has the element type, in which
+// case they build a balanced tree with the same result and O(log LEN)
+// depth.
+template <class FTOR, typename TI, typename TA, std::size_t LEN>
+CONSTEXPR17 auto _reduce(TI const& INIT, std::array<TA, LEN> const& IN, std::false_type) -> decltype(_rHelp<FTOR, LEN>::reduce(INIT, IN)){
+#pragma HLS INLINE
+	return _rHelp<FTOR, LEN>::reduce(INIT, IN);
+}
+
+template <class FTOR, typename TI, typename TA, std::size_t LEN>
+CONSTEXPR17 auto _reduce(TI const& INIT, std::array<TA, LEN> const& IN, std::true_type) -> decltype(FTOR()(INIT, treereduce<FTOR>(IN))){
+#pragma HLS INLINE
+	return FTOR()(INIT, treereduce<FTOR>(IN));
+}
 
+template <class FTOR, typename TI, typename TA, std::size_t LEN>
+CONSTEXPR17 auto _rreduce(std::array<TA, LEN> const& IN, TI const& INIT, std::false_type) -> decltype(_rHelp<FTOR, LEN>::rreduce(IN, INIT)){
+#pragma HLS INLINE
+	return _rHelp<FTOR, LEN>::rreduce(IN, INIT);
+}
+
+template <class FTOR, typename TI, typename TA, std::size_t LEN>
+CONSTEXPR17 auto _rreduce(std::array<TA, LEN> const& IN, TI const& INIT, std::true_type) -> decltype(FTOR()(treereduce<FTOR>(IN), INIT)){
+#pragma HLS INLINE
+	return FTOR()(treereduce<FTOR>(IN), INIT);
+}
 
+// The tree combines the elements in their own type TA and only applies
+// INIT at the root, while the chain accumulates in the type TI of INIT.
+// The tree is only used when the two are the same type, so that a wide
+// INIT (e.g. a long long sum of ints) keeps its range and precision.
 template <class FTOR, typename TI, typename TA, std::size_t LEN>
-auto rreduce(std::array<TA, LEN> const& IN, TI const& INIT) -> decltype(_rHelp<FTOR, LEN>().rreduce(IN, INIT)){
+using _use_tree = std::integral_constant<bool, is_associative<FTOR>::value && (LEN > 1) &&
+	std::is_same<TI, TA>::value>;
+
+template <class FTOR, typename TI, typename TA, std::size_t LEN>
+CONSTEXPR17 auto reduce(TI const& INIT, std::array<TA, LEN> const& IN) -> decltype(_reduce<FTOR>(INIT, IN, _use_tree<FTOR, TI, TA, LEN>())){
 #pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
 #pragma HLS INLINE
 #pragma HLS PIPELINE
-	return _rHelp<FTOR, LEN>::rreduce(IN, INIT);
+	return _reduce<FTOR>(INIT, IN, _use_tree<FTOR, TI, TA, LEN>());
+}
+
+// Reduces IN starting from the identity element of FTOR
+template <class FTOR, typename TA, std::size_t LEN>
+CONSTEXPR17 auto reduce(std::array<TA, LEN> const& IN) -> decltype(reduce<FTOR>(identity<FTOR>::template value<TA>(), IN)){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS INLINE
+#pragma HLS PIPELINE
+	return reduce<FTOR>(identity<FTOR>::template value<TA>(), IN);
+}
+
+template <class FTOR, typename TI, typename TA, std::size_t LEN>
+CONSTEXPR17 auto rreduce(std::array<TA, LEN> const& IN, TI const& INIT) -> decltype(_rreduce<FTOR>(IN, INIT, _use_tree<FTOR, TI, TA, LEN>())){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS INLINE
+#pragma HLS PIPELINE
+	return _rreduce<FTOR>(IN, INIT, _use_tree<FTOR, TI, TA, LEN>());
 }
 
-template <class FTOR>
+template <class POLICY>
+struct _reducePolicy;
+
+template <>
+struct _reducePolicy<unrolled>{
+	template <class FTOR, typename TI, typename TA, std::size_t LEN>
+	static CONSTEXPR17 auto reduce(TI const& INIT, std::array<TA, LEN> const& IN) -> decltype(::reduce<FTOR>(INIT, IN)){
+#pragma HLS INLINE
+		return ::reduce<FTOR>(INIT, IN);
+	}
+
+	template <class FTOR, typename TI, typename TA, std::size_t LEN>
+	static CONSTEXPR17 auto rreduce(std::array<TA, LEN> const& IN, TI const& INIT) -> decltype(::rreduce<FTOR>(IN, INIT)){
+#pragma HLS INLINE
+		return ::rreduce<FTOR>(IN, INIT);
+	}
+};
+
+// The folded reduce consumes F elements per iteration, and reduces each
+// group of F with reduce (i.e. with a tree when FTOR is associative), so
+// the loop-carried dependency is one FTOR per F elements.
+template <std::size_t F>
+struct _reducePolicy<folded<F> >{
+	template <class FTOR, typename TI, typename TA, std::size_t LEN>
+	static TI reduce(TI const& INIT, std::array<TA, LEN> const& IN){
+#pragma HLS ARRAY_PARTITION cyclic factor=F VARIABLE=IN._M_instance
+#pragma HLS INLINE
+		static_assert(LEN % F == 0, "Folding factor F must divide LEN");
+		TI acc = INIT;
+	HOPS_LABEL(reduce_folded_loop)
+		for(std::size_t i = 0; i < LEN / F; ++i){
+#pragma HLS PIPELINE
+			std::array<TA, F> chunk;
+#pragma HLS ARRAY_PARTITION complete VARIABLE=chunk._M_instance
+			for(std::size_t j = 0; j < F; ++j){
+#pragma HLS UNROLL
+				chunk[j] = IN[i * F + j];
+			}
+			acc = ::reduce<FTOR>(acc, chunk);
+		}
+		return acc;
+	}
+
+	template <class FTOR, typename TI, typename TA, std::size_t LEN>
+	static TI rreduce(std::array<TA, LEN> const& IN, TI const& INIT){
+#pragma HLS ARRAY_PARTITION cyclic factor=F VARIABLE=IN._M_instance
+#pragma HLS INLINE
+		static_assert(LEN % F == 0, "Folding factor F must divide LEN");
+		TI acc = INIT;
+	HOPS_LABEL(rreduce_folded_loop)
+		for(std::size_t i = LEN / F; i > 0; --i){
+#pragma HLS PIPELINE
+			std::array<TA, F> chunk;
+#pragma HLS ARRAY_PARTITION complete VARIABLE=chunk._M_instance
+			for(std::size_t j = 0; j < F; ++j){
+#pragma HLS UNROLL
+				chunk[j] = IN[(i - 1) * F + j];
+			}
+			acc = ::rreduce<FTOR>(chunk, acc);
+		}
+		return acc;
+	}
+};
+
+template <>
+struct _reducePolicy<streaming> : _reducePolicy<folded<1> >{};
+
+#ifndef __SYNTHESIS__
+// Each host thread reduces a contiguous chunk of IN, and the partial
+// results are combined in order, so FTOR must be associative. Otherwise
+// the host_par reduce is a sequential chain.
+template <>
+struct _reducePolicy<host_par>{
+	template <class FTOR, typename TA, std::size_t LEN>
+	static std::vector<TA> partials(std::array<TA, LEN> const& IN){
+		if(LEN == 0){
+			return std::vector<TA>();
+		}
+		std::size_t n = _host_threads(LEN);
+		std::size_t chunk = (LEN + n - 1) / n;
+		std::vector<TA> part((LEN + chunk - 1) / chunk);
+		_host_parallel_for(part.size(), [&](std::size_t t){
+				std::size_t end = (t + 1) * chunk < LEN ? (t + 1) * chunk : LEN;
+				TA p = IN[t * chunk];
+				for(std::size_t i = t * chunk + 1; i < end; ++i){
+					p = FTOR()(p, IN[i]);
+				}
+				part[t] = p;
+			});
+		return part;
+	}
+
+	template <class FTOR, typename TI, typename TA, std::size_t LEN>
+	static TI _reduce(TI const& INIT, std::array<TA, LEN> const& IN, std::true_type){
+		TI acc = INIT;
+		for(TA const& p : partials<FTOR>(IN)){
+			acc = FTOR()(acc, p);
+		}
+		return acc;
+	}
+
+	template <class FTOR, typename TI, typename TA, std::size_t LEN>
+	static TI _reduce(TI const& INIT, std::array<TA, LEN> const& IN, std::false_type){
+		return _reducePolicy<streaming>::reduce<FTOR>(INIT, IN);
+	}
+
+	template <class FTOR, typename TI, typename TA, std::size_t LEN>
+	static TI _rreduce(std::array<TA, LEN> const& IN, TI const& INIT, std::true_type){
+		std::vector<TA> part = partials<FTOR>(IN);
+		TI acc = INIT;
+		for(std::size_t t = part.size(); t > 0; --t){
+			acc = FTOR()(part[t - 1], acc);
+		}
+		return acc;
+	}
+
+	template <class FTOR, typename TI, typename TA, std::size_t LEN>
+	static TI _rreduce(std::array<TA, LEN> const& IN, TI const& INIT, std::false_type){
+		return _reducePolicy<streaming>::rreduce<FTOR>(IN, INIT);
+	}
+
+	template <class FTOR, typename TI, typename TA, std::size_t LEN>
+	static TI reduce(TI const& INIT, std::array<TA, LEN> const& IN){
+		return _reduce<FTOR>(INIT, IN, _use_tree<FTOR, TI, TA, LEN>());
+	}
+
+	template <class FTOR, typename TI, typename TA, std::size_t LEN>
+	static TI rreduce(std::array<TA, LEN> const& IN, TI const& INIT){
+		return _rreduce<FTOR>(IN, INIT, _use_tree<FTOR, TI, TA, LEN>());
+	}
+};
+#endif
+
+// reduce<FTOR, POLICY>(INIT, IN) and rreduce<FTOR, POLICY>(IN, INIT)
+// compute the same result as reduce<FTOR> and rreduce<FTOR>, using the
+// execution policy POLICY (see policy.hpp).
+template <class FTOR, class POLICY, typename TI, typename TA, std::size_t LEN>
+CONSTEXPR17 auto reduce(TI const& INIT, std::array<TA, LEN> const& IN) -> decltype(_reducePolicy<POLICY>::template reduce<FTOR>(INIT, IN)){
+#pragma HLS INLINE
+	return _reducePolicy<POLICY>::template reduce<FTOR>(INIT, IN);
+}
+
+template <class FTOR, class POLICY, typename TI, typename TA, std::size_t LEN>
+CONSTEXPR17 auto rreduce(std::array<TA, LEN> const& IN, TI const& INIT) -> decltype(_reducePolicy<POLICY>::template rreduce<FTOR>(IN, INIT)){
+#pragma HLS INLINE
+	return _reducePolicy<POLICY>::template rreduce<FTOR>(IN, INIT);
+}
+
+template <class FTOR, class POLICY = unrolled>
+struct Reduce{
+	template <typename TI, typename TA, std::size_t LEN>
+	CONSTEXPR17 auto operator()(TI const& INIT, std::array<TA, LEN> const& IN) -> decltype(reduce<FTOR, POLICY>(INIT, IN)){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS INLINE
+#pragma HLS PIPELINE
+		return reduce<FTOR, POLICY>(INIT, IN);
+	}
+};
+
+
+template <class FTOR, class POLICY = unrolled>
 struct Rreduce{
 	template <typename TI, typename TA, std::size_t LEN>
-	auto operator()(std::array<TA, LEN> const& IN, TI const& INIT) -> decltype(rreduce<FTOR>(IN, INIT)){
+	CONSTEXPR17 auto operator()(std::array<TA, LEN> const& IN, TI const& INIT) -> decltype(rreduce<FTOR, POLICY>(IN, INIT)){
 #pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
 #pragma HLS INLINE
 #pragma HLS PIPELINE
-		return rreduce<FTOR>(IN, INIT);
+		return rreduce<FTOR, POLICY>(IN, INIT);
+	}
+};
+
+// Streaming reduce for long lists. A chain of FTOR over a stream has a
+// loop-carried dependency through FTOR, so a multi-cycle operator (e.g. a
+// floating-point add) cannot accept one element per cycle. sreduce keeps
+// LANES partial results instead, and feeds them round-robin, so each lane
+// is only updated every LANES elements. The lanes are combined with
+// treereduce once LEN elements have been read from IN.
+//
+// Every lane is seeded with INIT, so INIT is combined into the result
+// LANES times: INIT must be an identity of FTOR (e.g. 0 for addition), not
+// a starting value such as a running total. Lanes reorder the input, so more than one lane requires
+// FTOR to be marked both associative and commutative (see traits.hpp).
+// LANES should be at least the latency of FTOR.
+template <class FTOR, std::size_t LANES, typename TI, typename TA, std::size_t DEPTH>
+TI sreduce(TI const& INIT, std::size_t LEN, stream<TA, DEPTH>& IN){
+#pragma HLS INLINE
+	static_assert(LANES > 0, "sreduce needs at least one lane");
+	static_assert(LANES == 1 || (is_associative<FTOR>::value && is_commutative<FTOR>::value),
+		"sreduce with LANES > 1 reorders the input: FTOR must be associative and commutative");
+	std::array<TI, LANES> acc = replicate<LANES>(INIT);
+#pragma HLS ARRAY_PARTITION complete VARIABLE=acc._M_instance
+	std::size_t lane = 0;
+HOPS_LABEL(sreduce_loop)
+	for(std::size_t i = 0; i < LEN; ++i){
+#pragma HLS PIPELINE II=1
+		// Each lane is rewritten every LANES iterations
+#pragma HLS DEPENDENCE variable=acc._M_instance inter true distance=LANES
+		acc[lane] = FTOR()(acc[lane], IN.read());
+		lane = (lane == LANES - 1) ? 0 : lane + 1;
+	}
+	return treereduce<FTOR>(acc);
+}
+
+template <class FTOR, std::size_t LANES>
+struct Sreduce{
+	template <typename TI, typename TA, std::size_t DEPTH>
+	TI operator()(TI const& INIT, std::size_t LEN, stream<TA, DEPTH>& IN){
+#pragma HLS INLINE
+		return sreduce<FTOR, LANES>(INIT, LEN, IN);
 	}
 };
 #endif // __REDUCE_HPP
@@ -0,0 +1,188 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#ifndef __SOA_HPP
+#define __SOA_HPP
+#include <array>
+#include <tuple>
+#include <utility>
+#include "listops.hpp"
+#include "map.hpp"
+#include "zip.hpp"
+
+// soa_array<LEN, TS...> is a zipped list stored as a struct of arrays: one
+// std::array<T, LEN> plane per field, rather than one array of tuples
+// (as returned by zip and zipN). Each plane is contiguous, so the host
+// can vectorize loops over it, and HLS can partition (or map to separate
+// memories) each plane independently.
+//
+// zip_soa builds one from its planes, and unzip/unzipN return references to
+// the planes, so unzipping is free. map and zipWith iterate the planes
+// directly, and pass the fields of each element to FTOR as separate
+// arguments.
+template <std::size_t LEN, class... TS>
+struct soa_array{
+	typedef std::tuple<std::array<TS, LEN>...> planes_t;
+	planes_t planes;
+
+	static constexpr std::size_t size(){
+		return LEN;
+	}
+
+	template <std::size_t IDX>
+	CONSTEXPR17 auto get() -> typename std::tuple_element<IDX, planes_t>::type&{
+		return std::get<IDX>(planes);
+	}
+
+	template <std::size_t IDX>
+	constexpr auto get() const -> typename std::tuple_element<IDX, planes_t>::type const&{
+		return std::get<IDX>(planes);
+	}
+
+	// Gathers element I (one field from every plane)
+	CONSTEXPR17 std::tuple<TS...> operator[](std::size_t I) const{
+		return _at(I, typename _mkidxseq<sizeof...(TS)>::type());
+	}
+
+	// Scatters V into element I
+	CONSTEXPR17 void set(std::size_t I, std::tuple<TS...> const& V){
+		_set(I, V, typename _mkidxseq<sizeof...(TS)>::type());
+	}
+
+private:
+	template <std::size_t... IDX>
+	CONSTEXPR17 std::tuple<TS...> _at(std::size_t I, _idxseq<IDX...>) const{
+		return std::tuple<TS...>(std::get<IDX>(planes)[I]...);
+	}
+
+	template <std::size_t... IDX>
+	CONSTEXPR17 void _set(std::size_t I, std::tuple<TS...> const& V, _idxseq<IDX...>){
+		int expand[] = {0, (std::get<IDX>(planes)[I] = std::get<IDX>(V), 0)...};
+		(void)expand;
+	}
+};
+
+// Builds a soa_array from its planes. The planes are taken by value, so
+// callers can std::move arrays they no longer need into the container.
+template <std::size_t LEN, class... TS>
+soa_array<LEN, TS...> zip_soa(std::array<TS, LEN>... INS){
+#pragma HLS INLINE
+	return soa_array<LEN, TS...>{typename soa_array<LEN, TS...>::planes_t(std::move(INS)...)};
+}
+
+struct ZipSoa{
+	template <std::size_t LEN, class... TS>
+	auto operator()(std::array<TS, LEN> const&... INS) -> decltype(zip_soa(INS...)){
+#pragma HLS INLINE
+		return zip_soa(INS...);
+	}
+};
+
+// The planes of IN, without copying them
+template <std::size_t LEN, class TL, class TR>
+constexpr auto unzip(soa_array<LEN, TL, TR> const& IN) -> 
+	std::pair<std::array<TL, LEN> const&, std::array<TR, LEN> const&>{
+	return {IN.template get<0>(), IN.template get<1>()};
+}
+
+template <std::size_t LEN, class... TS>
+constexpr auto unzipN(soa_array<LEN, TS...> const& IN) -> std::tuple<std::array<TS, LEN>...> const&{
+	return IN.planes;
+}
+
+// A temporary soa_array does not outlive the call, so references into it
+// would dangle: its planes are moved out and returned by value instead.
+template <std::size_t LEN, class TL, class TR>
+auto unzip(soa_array<LEN, TL, TR>&& IN) -> std::pair<std::array<TL, LEN>, std::array<TR, LEN>>{
+#pragma HLS INLINE
+	return {std::move(std::get<0>(IN.planes)), std::move(std::get<1>(IN.planes))};
+}
+
+template <std::size_t LEN, class... TS>
+auto unzipN(soa_array<LEN, TS...>&& IN) -> std::tuple<std::array<TS, LEN>...>{
+#pragma HLS INLINE
+	return std::move(IN.planes);
+}
+
+// Converts between a zipped list stored as an array of tuples and as a
+// struct of arrays
+template <std::size_t LEN, class... TS>
+auto to_soa(std::array<std::tuple<TS...>, LEN> const& IN) -> soa_array<LEN, TS...>{
+#pragma HLS INLINE
+	return soa_array<LEN, TS...>{unzipN(IN)};
+}
+
+template <std::size_t LEN, class... TS>
+auto to_aos(soa_array<LEN, TS...> const& IN) -> std::array<std::tuple<TS...>, LEN>{
+#pragma HLS INLINE
+	std::array<std::tuple<TS...>, LEN> temp;
+#pragma HLS ARRAY_PARTITION complete VARIABLE=temp._M_instance
+	for(std::size_t i = 0; i < LEN; ++i){
+#pragma HLS UNROLL
+		temp[i] = IN[i];
+	}
+	return temp;
+}
+
+template <class FTOR, std::size_t LEN, class... TS, std::size_t... IDX>
+CONSTEXPR17 auto _soaApply(soa_array<LEN, TS...> const& IN, std::size_t I, _idxseq<IDX...>) -> 
+	decltype(FTOR()(std::get<IDX>(IN.planes)[I]...)){
+#pragma HLS INLINE
+	return FTOR()(std::get<IDX>(IN.planes)[I]...);
+}
+
+// map<FTOR>(IN) over a soa_array calls FTOR with one argument per plane,
+// i.e. map<FTOR>(zip_soa(A, B, ...)) is zipWithN<FTOR>(A, B, ...)
+template <class FTOR, std::size_t LEN, class... TS>
+CONSTEXPR17 auto map(soa_array<LEN, TS...> const& IN) -> 
+	std::array<decltype(_soaApply<FTOR>(IN, 0, typename _mkidxseq<sizeof...(TS)>::type())), LEN>{
+#pragma HLS INLINE
+	std::array<decltype(_soaApply<FTOR>(IN, 0, typename _mkidxseq<sizeof...(TS)>::type())), LEN> temp{};
+#pragma HLS ARRAY_PARTITION complete VARIABLE=temp._M_instance
+	for(std::size_t i = 0; i < LEN; ++i){
+#pragma HLS UNROLL
+		temp[i] = _soaApply<FTOR>(IN, i, typename _mkidxseq<sizeof...(TS)>::type());
+	}
+	return temp;
+}
+
+// zipWith<FTOR>(IN) over a two-plane soa_array is zipWith<FTOR>(L, R) over
+// its planes
+template <class FTOR, std::size_t LEN, class TL, class TR>
+CONSTEXPR17 auto zipWith(soa_array<LEN, TL, TR> const& IN) -> 
+	decltype(zipWith<FTOR>(IN.template get<0>(), IN.template get<1>())){
+#pragma HLS INLINE
+	return zipWith<FTOR>(IN.template get<0>(), IN.template get<1>());
+}
+#endif // __SOA_HPP
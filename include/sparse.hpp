@@ -0,0 +1,317 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#ifndef __SPARSE_HPP
+#define __SPARSE_HPP
+#include <cstddef>
+#include <array>
+#include "listops.hpp"
+#include "reduce.hpp"
+#include "traits.hpp"
+
+// Sparse matrices, for lists where most elements are zero. Like the
+// dense R x C matrices of matrix.hpp (std::array<std::array<T, C>, R>),
+// the shape is part of the type, and so is NNZ, the capacity for
+// nonzeros; nnz() is how many are used.
+//
+// - csr_t<T, R, C, NNZ>: compressed sparse rows. The nonzeros of row r
+//   are val[rowptr[r]] to val[rowptr[r + 1] - 1], in column col[k].
+// - coo_t<T, R, C, NNZ>: coordinates. Nonzero k is val[k], at row[k]
+//   and col[k], in any order.
+//
+// to_csr, to_coo and to_dense convert between the three forms. A dense
+// matrix with more than NNZ nonzeros keeps the first NNZ in row-major
+// order; the overloads taking a DROPPED argument report how many did not
+// fit. The HOFs
+// only visit the nonzeros, so their cost is O(nnz) (plus O(R) for
+// row-wise operations) rather than O(R * C):
+//
+// - sparse_map<FTOR>(A): applies FTOR to every nonzero, keeping the
+//   sparsity pattern. FTOR(0) must be 0 (e.g. scaling, negation), since
+//   the zeros are not visited.
+// - sparse_reduce<FTOR, LANES>(INIT, A): reduces each row of a csr_t,
+//   returning a std::array<TI, R>. Every lane starts at INIT, so INIT
+//   must be an identity of FTOR; empty rows are INIT.
+// - spmv<LANES>(A, X): the product of a csr_t and a dense vector.
+//
+// The row-wise operations stream the nonzeros of each row through a
+// pipelined loop. As in sreduce, the loop-carried dependency through a
+// multi-cycle FTOR (e.g. a floating-point add) is broken by LANES
+// interleaved accumulators, updated round-robin and combined with
+// treereduce at the end of the row. Lanes reorder the nonzeros, so
+// sparse_reduce with LANES > 1 requires FTOR to be marked associative and
+// commutative (see traits.hpp). LANES should be at least the latency of
+// FTOR.
+template <typename T, std::size_t R, std::size_t C, std::size_t NNZ>
+struct csr_t{
+	std::array<std::size_t, R + 1> rowptr;
+	std::array<std::size_t, NNZ> col;
+	std::array<T, NNZ> val;
+
+	std::size_t nnz() const{
+		return rowptr[R];
+	}
+};
+
+template <typename T, std::size_t R, std::size_t C, std::size_t NNZ>
+struct coo_t{
+	std::size_t count;
+	std::array<std::size_t, NNZ> row;
+	std::array<std::size_t, NNZ> col;
+	std::array<T, NNZ> val;
+
+	std::size_t nnz() const{
+		return count;
+	}
+};
+
+// The nonzeros of IN, in row-major order. Only the first NNZ fit: any
+// further nonzeros are dropped, and DROPPED is set to how many were.
+template <std::size_t NNZ, typename T, std::size_t R, std::size_t C>
+csr_t<T, R, C, NNZ> to_csr(std::array<std::array<T, C>, R> const& IN, std::size_t& DROPPED){
+	csr_t<T, R, C, NNZ> out{};
+	std::size_t k = 0;
+	DROPPED = 0;
+	for(std::size_t r = 0; r < R; ++r){
+		out.rowptr[r] = k;
+		for(std::size_t c = 0; c < C; ++c){
+#pragma HLS PIPELINE II=1
+			if(IN[r][c] != T()){
+				if(k < NNZ){
+					out.col[k] = c;
+					out.val[k] = IN[r][c];
+					++k;
+				} else {
+					++DROPPED;
+				}
+			}
+		}
+	}
+	out.rowptr[R] = k;
+	return out;
+}
+
+template <std::size_t NNZ, typename T, std::size_t R, std::size_t C>
+csr_t<T, R, C, NNZ> to_csr(std::array<std::array<T, C>, R> const& IN){
+#pragma HLS INLINE
+	std::size_t dropped;
+	return to_csr<NNZ>(IN, dropped);
+}
+
+template <std::size_t NNZ, typename T, std::size_t R, std::size_t C>
+coo_t<T, R, C, NNZ> to_coo(std::array<std::array<T, C>, R> const& IN, std::size_t& DROPPED){
+	coo_t<T, R, C, NNZ> out{};
+	std::size_t k = 0;
+	DROPPED = 0;
+	for(std::size_t r = 0; r < R; ++r){
+		for(std::size_t c = 0; c < C; ++c){
+#pragma HLS PIPELINE II=1
+			if(IN[r][c] != T()){
+				if(k < NNZ){
+					out.row[k] = r;
+					out.col[k] = c;
+					out.val[k] = IN[r][c];
+					++k;
+				} else {
+					++DROPPED;
+				}
+			}
+		}
+	}
+	out.count = k;
+	return out;
+}
+
+template <std::size_t NNZ, typename T, std::size_t R, std::size_t C>
+coo_t<T, R, C, NNZ> to_coo(std::array<std::array<T, C>, R> const& IN){
+#pragma HLS INLINE
+	std::size_t dropped;
+	return to_coo<NNZ>(IN, dropped);
+}
+
+// Sorts the nonzeros of IN by row (a counting sort, which keeps the order
+// of the nonzeros within a row)
+template <typename T, std::size_t R, std::size_t C, std::size_t NNZ>
+csr_t<T, R, C, NNZ> to_csr(coo_t<T, R, C, NNZ> const& IN){
+	csr_t<T, R, C, NNZ> out{};
+	std::array<std::size_t, R + 1> next{};
+	for(std::size_t k = 0; k < IN.nnz(); ++k){
+		++out.rowptr[IN.row[k] + 1];
+	}
+	for(std::size_t r = 0; r < R; ++r){
+		out.rowptr[r + 1] += out.rowptr[r];
+		next[r] = out.rowptr[r];
+	}
+	for(std::size_t k = 0; k < IN.nnz(); ++k){
+		std::size_t dst = next[IN.row[k]]++;
+		out.col[dst] = IN.col[k];
+		out.val[dst] = IN.val[k];
+	}
+	return out;
+}
+
+template <typename T, std::size_t R, std::size_t C, std::size_t NNZ>
+std::array<std::array<T, C>, R> to_dense(csr_t<T, R, C, NNZ> const& IN){
+	std::array<std::array<T, C>, R> out{};
+	for(std::size_t r = 0; r < R; ++r){
+		for(std::size_t k = IN.rowptr[r]; k < IN.rowptr[r + 1]; ++k){
+			out[r][IN.col[k]] = IN.val[k];
+		}
+	}
+	return out;
+}
+
+template <typename T, std::size_t R, std::size_t C, std::size_t NNZ>
+std::array<std::array<T, C>, R> to_dense(coo_t<T, R, C, NNZ> const& IN){
+	std::array<std::array<T, C>, R> out{};
+	for(std::size_t k = 0; k < IN.nnz(); ++k){
+		out[IN.row[k]][IN.col[k]] = IN.val[k];
+	}
+	return out;
+}
+
+template <class FTOR, typename T, std::size_t R, std::size_t C, std::size_t NNZ>
+auto sparse_map(csr_t<T, R, C, NNZ> const& IN) -> csr_t<decltype(FTOR()(IN.val[0])), R, C, NNZ>{
+	csr_t<decltype(FTOR()(IN.val[0])), R, C, NNZ> out{};
+	out.rowptr = IN.rowptr;
+	out.col = IN.col;
+HOPS_LABEL(sparse_map_loop)
+	for(std::size_t k = 0; k < IN.nnz(); ++k){
+#pragma HLS PIPELINE II=1
+		out.val[k] = FTOR()(IN.val[k]);
+	}
+	return out;
+}
+
+template <class FTOR, typename T, std::size_t R, std::size_t C, std::size_t NNZ>
+auto sparse_map(coo_t<T, R, C, NNZ> const& IN) -> coo_t<decltype(FTOR()(IN.val[0])), R, C, NNZ>{
+	coo_t<decltype(FTOR()(IN.val[0])), R, C, NNZ> out{};
+	out.count = IN.count;
+	out.row = IN.row;
+	out.col = IN.col;
+HOPS_LABEL(sparse_map_loop)
+	for(std::size_t k = 0; k < IN.nnz(); ++k){
+#pragma HLS PIPELINE II=1
+		out.val[k] = FTOR()(IN.val[k]);
+	}
+	return out;
+}
+
+// Nonzero K of a row-wise operation: the value, or the value times the
+// matching element of X
+template <typename T, std::size_t R, std::size_t C, std::size_t NNZ>
+struct _spValue{
+	csr_t<T, R, C, NNZ> const& A;
+
+	T operator()(std::size_t K) const{
+#pragma HLS INLINE
+		return A.val[K];
+	}
+};
+
+template <typename T, std::size_t R, std::size_t C, std::size_t NNZ>
+struct _spProduct{
+	csr_t<T, R, C, NNZ> const& A;
+	std::array<T, C> const& X;
+
+	T operator()(std::size_t K) const{
+#pragma HLS INLINE
+		return A.val[K] * X[A.col[K]];
+	}
+};
+
+// Reduces the nonzeros of each row of A, as given by ELEM, with FTOR
+// over L interleaved lanes
+template <class FTOR, std::size_t L, typename TI, typename T, std::size_t R, std::size_t C, std::size_t NNZ, class ELEM>
+std::array<TI, R> _sparseRows(TI const& INIT, csr_t<T, R, C, NNZ> const& A, ELEM const& E){
+#pragma HLS INLINE
+	std::array<TI, R> out;
+HOPS_LABEL(sparse_row_loop)
+	for(std::size_t r = 0; r < R; ++r){
+		std::array<TI, L> acc = replicate<L>(INIT);
+#pragma HLS ARRAY_PARTITION complete VARIABLE=acc._M_instance
+		std::size_t lane = 0;
+	HOPS_LABEL(sparse_nnz_loop)
+		for(std::size_t k = A.rowptr[r]; k < A.rowptr[r + 1]; ++k){
+#pragma HLS PIPELINE II=1
+			// Each lane is rewritten every L nonzeros
+#pragma HLS DEPENDENCE variable=acc._M_instance inter true distance=L
+			acc[lane] = FTOR()(acc[lane], E(k));
+			lane = (lane == L - 1) ? 0 : lane + 1;
+		}
+		out[r] = treereduce<FTOR>(acc);
+	}
+	return out;
+}
+
+template <class FTOR, std::size_t LANES = 1, typename TI, typename T, std::size_t R, std::size_t C, std::size_t NNZ>
+std::array<TI, R> sparse_reduce(TI const& INIT, csr_t<T, R, C, NNZ> const& A){
+#pragma HLS INLINE
+	static_assert(LANES == 1 || (is_associative<FTOR>::value && is_commutative<FTOR>::value),
+		"sparse_reduce with LANES > 1 reorders the nonzeros: FTOR must be associative and commutative");
+	return _sparseRows<FTOR, LANES>(INIT, A, _spValue<T, R, C, NNZ>{A});
+}
+
+struct _spAdd{
+	template <typename T>
+	T operator()(T const& L, T const& R){
+#pragma HLS INLINE
+		return L + R;
+	}
+};
+
+template <std::size_t LANES = 4, typename T, std::size_t R, std::size_t C, std::size_t NNZ>
+std::array<T, R> spmv(csr_t<T, R, C, NNZ> const& A, std::array<T, C> const& X){
+#pragma HLS INLINE
+	return _sparseRows<_spAdd, LANES>(T(), A, _spProduct<T, R, C, NNZ>{A, X});
+}
+
+template <class FTOR, std::size_t LANES = 1>
+struct SparseReduce{
+	template <typename TI, typename T, std::size_t R, std::size_t C, std::size_t NNZ>
+	std::array<TI, R> operator()(TI const& INIT, csr_t<T, R, C, NNZ> const& A){
+#pragma HLS INLINE
+		return sparse_reduce<FTOR, LANES>(INIT, A);
+	}
+};
+
+template <std::size_t LANES = 4>
+struct Spmv{
+	template <typename T, std::size_t R, std::size_t C, std::size_t NNZ>
+	std::array<T, R> operator()(csr_t<T, R, C, NNZ> const& A, std::array<T, C> const& X){
+#pragma HLS INLINE
+		return spmv<LANES>(A, X);
+	}
+};
+#endif // __SPARSE_HPP
@@ -0,0 +1,131 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#ifndef __STENCIL_HPP
+#define __STENCIL_HPP
+#include <array>
+#include "listops.hpp"
+#include "stream.hpp"
+
+// stencil2d slides a KH x KW window over a raster-order image that is
+// WIDTH pixels wide. KH-1 line buffers (LINES) hold the previous rows and
+// WIN holds the current window, so each pixel is read exactly once. 
+//
+// After pixel (y, x) is shifted in, WIN[r][c] holds pixel 
+// (y - (KH-1) + r, x - (KW-1) + c), i.e. the window's bottom-right corner
+// is the newest pixel. Outputs are only meaningful once y >= KH-1 and 
+// x >= KW-1; before that the window holds the zero-initialized buffers or
+// pixels from the end of the previous row.
+template <std::size_t KH, std::size_t KW>
+struct _s2dHelp{
+	template <typename T, std::size_t WIDTH>
+	static void shift(std::array<std::array<T, WIDTH>, KH-1>& LINES,
+			std::array<std::array<T, KW>, KH>& WIN,
+			std::size_t COL, T const& PIX){
+#pragma HLS INLINE
+		std::array<T, KH> column;
+#pragma HLS ARRAY_PARTITION complete VARIABLE=column._M_instance
+	HOPS_LABEL(stencil_column_loop)
+		for(std::size_t r = 0; r < KH-1; ++r){
+#pragma HLS UNROLL
+			column[r] = LINES[r][COL];
+		}
+		column[KH-1] = PIX;
+	HOPS_LABEL(stencil_line_loop)
+		for(std::size_t r = 0; r < KH-1; ++r){
+#pragma HLS UNROLL
+			LINES[r][COL] = column[r+1];
+		}
+	HOPS_LABEL(stencil_window_loop)
+		for(std::size_t r = 0; r < KH; ++r){
+#pragma HLS UNROLL
+			WIN[r] = shiftl(WIN[r], column[r]);
+		}
+	}
+};
+
+// Processes one row of the image, producing one output per pixel. LINES
+// and WIN carry state from one row to the next.
+template <class FTOR, std::size_t KH, std::size_t KW, std::size_t WIDTH, typename T>
+auto stencil2d(std::array<std::array<T, WIDTH>, KH-1>& LINES,
+		std::array<std::array<T, KW>, KH>& WIN,
+		std::array<T, WIDTH> const& ROW)
+	-> std::array<decltype(FTOR()(WIN)), WIDTH>{
+#pragma HLS ARRAY_PARTITION complete dim=1 VARIABLE=LINES._M_instance
+#pragma HLS ARRAY_PARTITION complete VARIABLE=WIN._M_instance
+#pragma HLS INLINE
+	std::array<decltype(FTOR()(WIN)), WIDTH> temp;
+HOPS_LABEL(stencil2d_loop)
+	for(std::size_t x = 0; x < WIDTH; ++x){
+#pragma HLS PIPELINE II=1
+		_s2dHelp<KH, KW>::shift(LINES, WIN, x, ROW[x]);
+		temp[x] = FTOR()(WIN);
+	}
+	return temp;
+}
+
+// Streaming form of stencil2d: HEIGHT rows of WIDTH pixels are read from
+// IN in raster order, and one output per pixel is written to OUT.
+template <class FTOR, std::size_t KH, std::size_t KW, std::size_t WIDTH, 
+	typename T, std::size_t DI, typename TO, std::size_t DO>
+void stencil2d(std::size_t HEIGHT, stream<T, DI>& IN, stream<TO, DO>& OUT){
+#pragma HLS INLINE
+	std::array<std::array<T, WIDTH>, KH-1> lines;
+#pragma HLS ARRAY_PARTITION complete dim=1 VARIABLE=lines._M_instance
+	std::array<std::array<T, KW>, KH> win;
+#pragma HLS ARRAY_PARTITION complete VARIABLE=win._M_instance
+	lines = replicate<KH-1>(replicate<WIDTH>(T()));
+	win = replicate<KH>(replicate<KW>(T()));
+HOPS_LABEL(stencil2d_row_loop)
+	for(std::size_t y = 0; y < HEIGHT; ++y){
+	HOPS_LABEL(stencil2d_col_loop)
+		for(std::size_t x = 0; x < WIDTH; ++x){
+#pragma HLS PIPELINE II=1
+			_s2dHelp<KH, KW>::shift(lines, win, x, IN.read());
+			OUT.write(FTOR()(win));
+		}
+	}
+}
+
+template <class FTOR, std::size_t KH, std::size_t KW, std::size_t WIDTH>
+struct Stencil2d{
+	template <typename T>
+	auto operator()(std::array<std::array<T, WIDTH>, KH-1>& LINES,
+			std::array<std::array<T, KW>, KH>& WIN,
+			std::array<T, WIDTH> const& ROW) -> decltype(stencil2d<FTOR, KH, KW, WIDTH>(LINES, WIN, ROW)){
+#pragma HLS INLINE
+		return stencil2d<FTOR, KH, KW, WIDTH>(LINES, WIN, ROW);
+	}
+};
+#endif // __STENCIL_HPP
@@ -0,0 +1,229 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#ifndef __STREAM_HPP
+#define __STREAM_HPP
+#include <cstddef>
+#include "constops.hpp"
+#ifdef __SYNTHESIS__
+#include "hls_stream.h"
+
+// Under synthesis a stream is an hls::stream with a FIFO of DEPTH
+// elements. Vitis HLS takes the depth as a template argument. Vivado HLS
+// can only set it with a STREAM pragma on the stream variable itself, so
+// there the kernel that declares the stream must add
+// "#pragma HLS STREAM variable=<name> depth=<DEPTH>"; otherwise it gets
+// the tool's default depth.
+#ifdef __VITIS_HLS__
+template <typename T, std::size_t DEPTH = 2>
+class stream : public hls::stream<T, DEPTH>{
+public:
+	stream() : hls::stream<T, DEPTH>(){}
+	stream(const char * NAME) : hls::stream<T, DEPTH>(NAME){}
+};
+#else
+template <typename T, std::size_t DEPTH = 2>
+class stream : public hls::stream<T>{
+public:
+	stream() : hls::stream<T>(){}
+	stream(const char * NAME) : hls::stream<T>(NAME){}
+};
+#endif
+#else
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+// In C-sim a stream is a lock-free single-producer/single-consumer queue.
+// Like hls::stream in C-sim its storage is unbounded: blocking writes
+// never wait, so a dataflow region that runs its processes one after the
+// other in a single thread cannot deadlock on a shallow stream. DEPTH is
+// still the FIFO depth seen by full() and write_nb(), and sets the size of
+// the blocks the queue is built from.
+//
+// The producer and consumer indices live on separate cache lines, and each
+// side keeps a private copy of the other side's index so that the shared
+// lines are only touched when the cached copy says the queue is full (or
+// empty). A drained block is kept as a spare for the producer, so a queue
+// that stays short does not allocate.
+//
+// A blocking read spins (and yields) until an element arrives, so a kernel
+// can run in its own std::thread. A read that waits for more than a second
+// prints a warning, since in a single thread it will never complete.
+template <typename T, std::size_t DEPTH = 2>
+class stream{
+	static const std::size_t CACHE_LINE = 64;
+	static const std::size_t MIN_BLOCK = 64;
+	static const std::size_t BLOCK = (DEPTH > MIN_BLOCK) ? (1 << clog2(DEPTH)) : MIN_BLOCK;
+	static const std::size_t MASK = BLOCK - 1;
+
+	struct _block{
+		std::array<T, BLOCK> _M_buf;
+		_block * _M_next = nullptr;
+	};
+
+	// Consumer-owned
+	alignas(CACHE_LINE) std::atomic<std::size_t> _M_head;
+	std::size_t _M_tail_cache;
+	_block * _M_head_blk;
+	// Producer-owned
+	alignas(CACHE_LINE) std::atomic<std::size_t> _M_tail;
+	std::size_t _M_head_cache;
+	_block * _M_tail_blk;
+	// Handed from the consumer back to the producer
+	alignas(CACHE_LINE) std::atomic<_block *> _M_spare;
+
+	// Called by the producer before writing the first element of a block.
+	// The link is published by the release store of _M_tail that follows.
+	void _next_block(){
+		_block * b = _M_spare.exchange(nullptr, std::memory_order_acquire);
+		if(!b){
+			b = new _block();
+		}
+		b->_M_next = nullptr;
+		_M_tail_blk->_M_next = b;
+		_M_tail_blk = b;
+	}
+
+	void _push(T const& IN){
+		std::size_t t = _M_tail.load(std::memory_order_relaxed);
+		if(t != 0 && (t & MASK) == 0){
+			_next_block();
+		}
+		_M_tail_blk->_M_buf[t & MASK] = IN;
+		_M_tail.store(t + 1, std::memory_order_release);
+	}
+
+public:
+	stream() : _M_head(0), _M_tail_cache(0), _M_head_blk(new _block()),
+		_M_tail(0), _M_head_cache(0), _M_tail_blk(_M_head_blk), _M_spare(nullptr){}
+	stream(const char * NAME) : stream(){}
+	stream(const stream&) = delete;
+	stream& operator=(const stream&) = delete;
+
+	~stream(){
+		while(_M_head_blk){
+			_block * next = _M_head_blk->_M_next;
+			delete _M_head_blk;
+			_M_head_blk = next;
+		}
+		delete _M_spare.load();
+	}
+
+	bool empty(){
+		std::size_t h = _M_head.load(std::memory_order_relaxed);
+		if(h != _M_tail_cache){
+			return false;
+		}
+		_M_tail_cache = _M_tail.load(std::memory_order_acquire);
+		return h == _M_tail_cache;
+	}
+
+	// True when DEPTH elements are waiting, i.e. when the synthesized FIFO
+	// would be full. A blocking write still succeeds.
+	bool full(){
+		std::size_t t = _M_tail.load(std::memory_order_relaxed);
+		if(t - _M_head_cache < DEPTH){
+			return false;
+		}
+		_M_head_cache = _M_head.load(std::memory_order_acquire);
+		return t - _M_head_cache >= DEPTH;
+	}
+
+	std::size_t size() const{
+		return _M_tail.load(std::memory_order_acquire) - 
+			_M_head.load(std::memory_order_acquire);
+	}
+
+	bool read_nb(T& OUT){
+		if(empty()){
+			return false;
+		}
+		std::size_t h = _M_head.load(std::memory_order_relaxed);
+		if(h != 0 && (h & MASK) == 0){
+			_block * old = _M_head_blk;
+			_M_head_blk = old->_M_next;
+			delete _M_spare.exchange(old, std::memory_order_release);
+		}
+		OUT = _M_head_blk->_M_buf[h & MASK];
+		_M_head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool write_nb(T const& IN){
+		if(full()){
+			return false;
+		}
+		_push(IN);
+		return true;
+	}
+
+	void read(T& OUT){
+		if(read_nb(OUT)){
+			return;
+		}
+		auto start = std::chrono::steady_clock::now();
+		bool warned = false;
+		while(!read_nb(OUT)){
+			if(!warned && std::chrono::steady_clock::now() - start > std::chrono::seconds(1)){
+				fprintf(stderr, "Warning: stream read has waited 1 s on an empty stream. "
+					"Nothing is writing to it, or the reader runs before the writer in the same thread.\n");
+				warned = true;
+			}
+			std::this_thread::yield();
+		}
+	}
+
+	T read(){
+		T temp;
+		read(temp);
+		return temp;
+	}
+
+	void write(T const& IN){
+		_push(IN);
+	}
+
+	void operator>>(T& OUT){
+		read(OUT);
+	}
+
+	void operator<<(T const& IN){
+		write(IN);
+	}
+};
+#endif // __SYNTHESIS__
+#endif // __STREAM_HPP
@@ -0,0 +1,74 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#ifndef __TRAITS_HPP
+#define __TRAITS_HPP
+#include <type_traits>
+#include "hof.hpp"
+
+// Algebraic properties of functors. These are opt-in: a functor is
+// assumed to be neither associative nor commutative, and to have no
+// identity element, unless the traits below are specialized for it:
+//
+//	template <> struct is_associative<Min> : std::true_type{};
+//	template <> struct is_commutative<Min> : std::true_type{};
+//	template <> struct identity<Min>{
+//		template <typename T>
+//		static constexpr T value(){ return std::numeric_limits<T>::max(); }
+//	};
+//
+// reduce and rreduce use a balanced tree for associative functors and a
+// chain otherwise; sreduce needs both properties to split its input
+// across lanes.
+template <class FTOR>
+struct is_associative : std::false_type{};
+
+template <class FTOR>
+struct is_commutative : std::false_type{};
+
+// identity<FTOR>::value<T>() is the identity element of FTOR on T. 
+template <class FTOR>
+struct identity{};
+
+// Flipping the arguments of an associative (or commutative) functor
+// keeps it associative (or commutative)
+template <class FTOR>
+struct is_associative<Flip<FTOR> > : is_associative<FTOR>{};
+
+template <class FTOR>
+struct is_commutative<Flip<FTOR> > : is_commutative<FTOR>{};
+
+template <class FTOR>
+struct identity<Flip<FTOR> > : identity<FTOR>{};
+#endif // __TRAITS_HPP
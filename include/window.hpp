@@ -0,0 +1,87 @@
+// ----------------------------------------------------------------------
+// Copyright (c) 2016, The Regents of the University of California All
+// rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are
+// met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials provided
+//       with the distribution.
+//
+//     * Neither the name of The Regents of the University of California
+//       nor the names of its contributors may be used to endorse or
+//       promote products derived from this software without specific
+//       prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL REGENTS OF THE
+// UNIVERSITY OF CALIFORNIA BE LIABLE FOR ANY DIRECT, INDIRECT,
+// INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+// BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+// OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR
+// TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+// ----------------------------------------------------------------------
+#ifndef __WINDOW_HPP
+#define __WINDOW_HPP
+#include <array>
+#include "listops.hpp"
+#include "stream.hpp"
+
+// window keeps a W-element shift register (REG) over its input and applies
+// FTOR to the register after every element is shifted in. The newest
+// element is REG[0] and the oldest is REG[W-1], so REG[k] holds the input
+// from k elements ago. REG carries state between calls, so consecutive
+// frames of one signal can be passed through the same register.
+template <class FTOR, std::size_t W, typename TA, std::size_t LEN>
+auto window(std::array<TA, W>& REG, std::array<TA, LEN> const& IN)
+	-> std::array<decltype(FTOR()(REG)), LEN>{
+#pragma HLS ARRAY_PARTITION complete VARIABLE=REG._M_instance
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS INLINE
+	std::array<decltype(FTOR()(REG)), LEN> temp;
+#pragma HLS ARRAY_PARTITION complete VARIABLE=temp._M_instance
+HOPS_LABEL(window_loop)
+	for(std::size_t i = 0; i < LEN; ++i){
+#pragma HLS UNROLL
+		REG = shiftr(IN[i], REG);
+		temp[i] = FTOR()(REG);
+	}
+	return temp;
+}
+
+// Streaming form of window: LEN elements are read from IN and one result
+// per element is written to OUT, at one element per cycle.
+template <class FTOR, std::size_t W, typename TA, std::size_t DI, typename TO, std::size_t DO>
+void window(std::size_t LEN, std::array<TA, W>& REG, stream<TA, DI>& IN, stream<TO, DO>& OUT){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=REG._M_instance
+#pragma HLS INLINE
+HOPS_LABEL(window_stream_loop)
+	for(std::size_t i = 0; i < LEN; ++i){
+#pragma HLS PIPELINE II=1
+		REG = shiftr(IN.read(), REG);
+		OUT.write(FTOR()(REG));
+	}
+}
+
+template <class FTOR, std::size_t W>
+struct Window{
+	template <typename TA, std::size_t LEN>
+	auto operator()(std::array<TA, W>& REG, std::array<TA, LEN> const& IN) -> decltype(window<FTOR, W>(REG, IN)){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=REG._M_instance
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS INLINE
+		return window<FTOR, W>(REG, IN);
+	}
+};
+#endif // __WINDOW_HPP
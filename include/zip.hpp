@@ -35,16 +35,19 @@
 #ifndef __ZIPPER_HPP
 #define __ZIPPER_HPP
 #include <utility>
+#include <tuple>
 #include "listops.hpp"
+#include "policy.hpp"
 template <class TL, class TR, std::size_t LEN>
-auto unzip(const std::array<std::pair<TL, TR>, LEN> IN) ->
+CONSTEXPR17 auto unzip(const std::array<std::pair<TL, TR>, LEN>& IN) ->
 	std::pair<std::array<TL, LEN>, std::array<TR, LEN> >{
 #pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
-	std::array<TL, LEN> left, right;
+	std::array<TL, LEN> left{};
+	std::array<TR, LEN> right{};
 #pragma HLS ARRAY_PARTITION complete VARIABLE=left._M_instance
 #pragma HLS ARRAY_PARTITION complete VARIABLE=right._M_instance
 #pragma HLS INLINE
-unzip_loop:
+CONSTEXPR17_LABEL(unzip_loop)
 	for(int i = 0; i < LEN; ++i){
 #pragma HLS UNROLL
 		left[i] = IN[i].first;
@@ -56,7 +59,7 @@ unzip_loop:
 
 struct Unzip{
 	template <class TL, class TR, std::size_t LEN>
-	auto operator ()(const std::array<std::pair<TL, TR>, LEN> IN) ->decltype(unzip(IN)){
+	CONSTEXPR17 auto operator ()(const std::array<std::pair<TL, TR>, LEN>& IN) ->decltype(unzip(IN)){
 #pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
 #pragma HLS INLINE
 		return unzip(IN);
@@ -64,13 +67,13 @@ struct Unzip{
 };
 
 template <class TL, class TR, std::size_t LEN>
-auto zip(const std::array<TL, LEN>& L, const std::array<TR, LEN>& R) -> std::array<std::pair<TL, TR>, LEN>{
+CONSTEXPR17 auto zip(const std::array<TL, LEN>& L, const std::array<TR, LEN>& R) -> std::array<std::pair<TL, TR>, LEN>{
 #pragma HLS ARRAY_PARTITION complete VARIABLE=L._M_instance
 #pragma HLS ARRAY_PARTITION complete VARIABLE=R._M_instance
 #pragma HLS INLINE
-	std::array<std::pair<TL, TR>, LEN> temp;
+	std::array<std::pair<TL, TR>, LEN> temp{};
 #pragma HLS ARRAY_PARTITION complete VARIABLE=temp._M_instance
-zip_loop:
+CONSTEXPR17_LABEL(zip_loop)
 	for(int i = 0; i < LEN; ++i){
 #pragma HLS UNROLL
 		temp[i] = {L[i], R[i]};
@@ -80,7 +83,7 @@ zip_loop:
 
 struct Zip{
 	template <class TL, class TR, std::size_t LEN>
-	auto operator ()(const std::array<TL, LEN>& L, const std::array<TR, LEN>& R) -> decltype(zip(L, R)) {
+	CONSTEXPR17 auto operator ()(const std::array<TL, LEN>& L, const std::array<TR, LEN>& R) -> decltype(zip(L, R)) {
 #pragma HLS ARRAY_PARTITION complete VARIABLE=L._M_instance
 #pragma HLS ARRAY_PARTITION complete VARIABLE=R._M_instance
 #pragma HLS INLINE
@@ -89,13 +92,13 @@ struct Zip{
 };
 
 template <class FTOR, class TL, class TR, std::size_t LEN>
-auto zipWith(const std::array<TL, LEN>& L, const std::array<TR, LEN>& R) -> std::array<decltype(FTOR()(L[0], R[0])), LEN>{
+CONSTEXPR17 auto zipWith(const std::array<TL, LEN>& L, const std::array<TR, LEN>& R) -> std::array<decltype(FTOR()(L[0], R[0])), LEN>{
 #pragma HLS ARRAY_PARTITION complete VARIABLE=L._M_instance
 #pragma HLS ARRAY_PARTITION complete VARIABLE=R._M_instance
 #pragma HLS INLINE
-	std::array<decltype(FTOR()(L[0], R[0])), LEN> temp;
+	std::array<decltype(FTOR()(L[0], R[0])), LEN> temp{};
 #pragma HLS ARRAY_PARTITION complete VARIABLE=temp._M_instance
-zipWith_loop:
+CONSTEXPR17_LABEL(zipWith_loop)
 	for(int i = 0; i < LEN; ++i){
 #pragma HLS UNROLL
 		temp[i] = FTOR()(L[i], R[i]);
@@ -103,14 +106,191 @@ zipWith_loop:
 	return temp;
 }
 
-template <class FTOR>
+// zipWith_into<FTOR>(L, R, OUT) writes zipWith<FTOR>(L, R) into OUT, so a
+// caller can reuse its output list (or pass L or R as OUT).
+template <class FTOR, class TL, class TR, class TO, std::size_t LEN>
+CONSTEXPR17 void zipWith_into(const std::array<TL, LEN>& L, const std::array<TR, LEN>& R, std::array<TO, LEN>& OUT){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=L._M_instance
+#pragma HLS ARRAY_PARTITION complete VARIABLE=R._M_instance
+#pragma HLS ARRAY_PARTITION complete VARIABLE=OUT._M_instance
+#pragma HLS INLINE
+	for(std::size_t i = 0; i < LEN; ++i){
+#pragma HLS UNROLL
+		OUT[i] = FTOR()(L[i], R[i]);
+	}
+}
+
+template <class POLICY>
+struct _zipWithPolicy;
+
+template <>
+struct _zipWithPolicy<unrolled>{
+	template <class FTOR, class TL, class TR, std::size_t LEN>
+	static CONSTEXPR17 auto zipWith(const std::array<TL, LEN>& L, const std::array<TR, LEN>& R) -> decltype(::zipWith<FTOR>(L, R)){
+#pragma HLS INLINE
+		return ::zipWith<FTOR>(L, R);
+	}
+};
+
+template <std::size_t F>
+struct _zipWithPolicy<folded<F> >{
+	template <class FTOR, class TL, class TR, std::size_t LEN>
+	static auto zipWith(const std::array<TL, LEN>& L, const std::array<TR, LEN>& R) -> std::array<decltype(FTOR()(L[0], R[0])), LEN>{
+#pragma HLS ARRAY_PARTITION cyclic factor=F VARIABLE=L._M_instance
+#pragma HLS ARRAY_PARTITION cyclic factor=F VARIABLE=R._M_instance
+#pragma HLS INLINE
+		std::array<decltype(FTOR()(L[0], R[0])), LEN> temp;
+#pragma HLS ARRAY_PARTITION cyclic factor=F VARIABLE=temp._M_instance
+	HOPS_LABEL(zipWith_folded_loop)
+		for(std::size_t i = 0; i < LEN; ++i){
+#pragma HLS PIPELINE
+#pragma HLS UNROLL factor=F
+			temp[i] = FTOR()(L[i], R[i]);
+		}
+		return temp;
+	}
+};
+
+template <>
+struct _zipWithPolicy<streaming> : _zipWithPolicy<folded<1> >{};
+
+#ifndef __SYNTHESIS__
+template <>
+struct _zipWithPolicy<host_par>{
+	template <class FTOR, class TL, class TR, std::size_t LEN>
+	static auto zipWith(const std::array<TL, LEN>& L, const std::array<TR, LEN>& R) -> std::array<decltype(FTOR()(L[0], R[0])), LEN>{
+		std::array<decltype(FTOR()(L[0], R[0])), LEN> temp;
+		_host_parallel_for(LEN, [&](std::size_t i){
+				temp[i] = FTOR()(L[i], R[i]);
+			});
+		return temp;
+	}
+};
+#endif
+
+// zipWith<FTOR, POLICY>(L, R) computes the same result as zipWith<FTOR>(L,
+// R), using the execution policy POLICY (see policy.hpp)
+template <class FTOR, class POLICY, class TL, class TR, std::size_t LEN>
+CONSTEXPR17 auto zipWith(const std::array<TL, LEN>& L, const std::array<TR, LEN>& R) -> decltype(_zipWithPolicy<POLICY>::template zipWith<FTOR>(L, R)){
+#pragma HLS INLINE
+	return _zipWithPolicy<POLICY>::template zipWith<FTOR>(L, R);
+}
+
+template <class FTOR, class POLICY = unrolled>
 struct ZipWith{
 	template <class TL, class TR, std::size_t LEN>
-	auto operator ()(const std::array<TL, LEN>& L, const std::array<TR, LEN>& R) -> decltype(zipWith<FTOR>(L, R)) {
+	CONSTEXPR17 auto operator ()(const std::array<TL, LEN>& L, const std::array<TR, LEN>& R) -> decltype(zipWith<FTOR, POLICY>(L, R)) {
 #pragma HLS ARRAY_PARTITION complete VARIABLE=L._M_instance
 #pragma HLS ARRAY_PARTITION complete VARIABLE=R._M_instance
 #pragma HLS INLINE
-		return zipWith<FTOR>(L, R);
+		return zipWith<FTOR, POLICY>(L, R);
+	}
+};
+
+// N-ary zip, zipWith and unzip over std::tuple. zipWithN applies FTOR to
+// the i-th element of every input in one pass, so multi-operand kernels
+// (e.g. a*b + c) need neither nested pairs nor extra zip passes.
+template <std::size_t LEN, class... TS>
+CONSTEXPR17 auto zipN(const std::array<TS, LEN>&... INS) -> std::array<std::tuple<TS...>, LEN>{
+#pragma HLS INLINE
+	std::array<std::tuple<TS...>, LEN> temp{};
+#pragma HLS ARRAY_PARTITION complete VARIABLE=temp._M_instance
+	for(std::size_t i = 0; i < LEN; ++i){
+#pragma HLS UNROLL
+		temp[i] = std::tuple<TS...>(INS[i]...);
+	}
+	return temp;
+}
+
+struct ZipN{
+	template <std::size_t LEN, class... TS>
+	CONSTEXPR17 auto operator()(const std::array<TS, LEN>&... INS) -> decltype(zipN(INS...)){
+#pragma HLS INLINE
+		return zipN(INS...);
+	}
+};
+
+template <class FTOR, std::size_t LEN, class... TS>
+CONSTEXPR17 auto zipWithN(const std::array<TS, LEN>&... INS) -> std::array<decltype(FTOR()(INS[0]...)), LEN>{
+#pragma HLS INLINE
+	std::array<decltype(FTOR()(INS[0]...)), LEN> temp{};
+#pragma HLS ARRAY_PARTITION complete VARIABLE=temp._M_instance
+	for(std::size_t i = 0; i < LEN; ++i){
+#pragma HLS UNROLL
+		temp[i] = FTOR()(INS[i]...);
+	}
+	return temp;
+}
+
+template <class FTOR>
+struct ZipWithN{
+	template <std::size_t LEN, class... TS>
+	CONSTEXPR17 auto operator()(const std::array<TS, LEN>&... INS) -> decltype(zipWithN<FTOR>(INS...)){
+#pragma HLS INLINE
+		return zipWithN<FTOR>(INS...);
+	}
+};
+
+// _idxseq<0, 1, ..., N-1> (std::index_sequence is not available in C++11).
+// The sequence is built from two halves, so the template recursion is
+// log2(N) deep rather than N.
+template <std::size_t... IDX>
+struct _idxseq{};
+
+template <class L, class R>
+struct _catidxseq;
+
+template <std::size_t... L, std::size_t... R>
+struct _catidxseq<_idxseq<L...>, _idxseq<R...> >{
+	typedef _idxseq<L..., (sizeof...(L) + R)...> type;
+};
+
+template <std::size_t N>
+struct _mkidxseq : _catidxseq<typename _mkidxseq<N/2>::type, typename _mkidxseq<N - N/2>::type>{};
+
+template <>
+struct _mkidxseq<0>{
+	typedef _idxseq<> type;
+};
+
+template <>
+struct _mkidxseq<1>{
+	typedef _idxseq<0> type;
+};
+
+template <std::size_t IDX, class... TS, std::size_t LEN>
+CONSTEXPR17 auto _unzipN(const std::array<std::tuple<TS...>, LEN>& IN) -> 
+	std::array<typename std::tuple_element<IDX, std::tuple<TS...> >::type, LEN>{
+#pragma HLS INLINE
+	std::array<typename std::tuple_element<IDX, std::tuple<TS...> >::type, LEN> temp{};
+#pragma HLS ARRAY_PARTITION complete VARIABLE=temp._M_instance
+	for(std::size_t i = 0; i < LEN; ++i){
+#pragma HLS UNROLL
+		temp[i] = std::get<IDX>(IN[i]);
+	}
+	return temp;
+}
+
+template <class... TS, std::size_t LEN, std::size_t... IDX>
+CONSTEXPR17 auto _unzipN(const std::array<std::tuple<TS...>, LEN>& IN, _idxseq<IDX...>) -> 
+	std::tuple<std::array<TS, LEN>...>{
+#pragma HLS INLINE
+	return std::tuple<std::array<TS, LEN>...>(_unzipN<IDX>(IN)...);
+}
+
+template <class... TS, std::size_t LEN>
+CONSTEXPR17 auto unzipN(const std::array<std::tuple<TS...>, LEN>& IN) -> std::tuple<std::array<TS, LEN>...>{
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS INLINE
+	return _unzipN(IN, typename _mkidxseq<sizeof...(TS)>::type());
+}
+
+struct UnzipN{
+	template <class... TS, std::size_t LEN>
+	CONSTEXPR17 auto operator()(const std::array<std::tuple<TS...>, LEN>& IN) -> decltype(unzipN(IN)){
+#pragma HLS ARRAY_PARTITION complete VARIABLE=IN._M_instance
+#pragma HLS INLINE
+		return unzipN(IN);
 	}
 };
 